@@ -1,183 +1,275 @@
-"""
-
-/* ***************************************************************************
-* File:    font_gen.py
-* Date:    2021.08.10
-* Author:  Bradan Lane STUDIO
-*
-* This content may be redistributed and/or modified as outlined
-* under the MIT License
-*
-* ******************************************************************************/
-
-/* ---
-# SMART Response XE Font Generation
-
-Getting fonts to look good on the SRXE LCD is 25% trial and error, 33% subjective, 50% rendering engine, and 10% your code.
-
-This `font_gen.py` program generates header files that are specific to the SRXEcore text renderer. It was not written to
-match any previous format. The program will output a series of header files with bitmap data for a font at a designated W*H.
-The output data is _width first_ to match the way the rendering engine on the SRXEcore works.
-Also, _width first_ is how the LCD bitmap on a SRXE is formatted.
-
-The general workflow for generating new font files is as follows:
- - find a font that will look good at the resolution you need. The best source is [Old School Fonts](https://int10h.org/oldschool-pc-fonts/)
- - adjust the parameters (ID number, point size, y offset, width, and height) until the resulting `PNG` looks good
- - include the generated header file(s) in your code
-
-The SRXEcore will compile out any rendering engine code not used so only include the generated headers you will actually use.
-
-### FONTS
-
-Only use monospace fonts. This code does not attempt to clean up and space out proportional fonts ... at least not very well.
-Ideally, the font width will be a multiple of 3. This will look best on the SRXE LCD display. The rendering engine will add whitespace
-between characters to pad out to the 3-pixel boundary required by the LCD driver.
-
-Fonts are somewhat subjective - especially at small sizes. Some people may have difficulty reading some fonts.
-Here are the best fonts I was able to find:
-
-|LABEL|WxH|DESCRIPTION|
-|:-----|:-----:|:-----|
-|TINY|6x8|The HP100LX is possible the best tiny font available|
-|SMALL|8x12|the Toshiba 8x14 can be tweeked quite a bit to make an excellent small font|
-|SMALL|9x15|the IBM XGA AI 7x15 is a clean contemporary looking font|
-|MEDIUM|12x18|the IBM XGA AI 12x23 makes a clean contemporary looking medium font|
-|LARGE|15x28|the IBM XGA AI 7x15 (doubled) actually looks a bit better that the 12x23|
-
-**Memory Usage:** If memory usage is a concern, the the `TINY` may be doubled to make a `MEDIUM` and the `SMALL` may be doubled to make a `LARGE`.
-The Toshiba font is better for doubling than the IBM font.
-
-_See the `lcdFontConfig()` and `lcdFontClone()` functions for details on doubling.
-
-### Notes
-
-Most fonts drop the underscore character to the very bottom of the font cell and below any other glyph pixels.
-This results in the need to make a font taller than it would otherwise need to be. For this reason, this program
-forces the underscore to the bottom most available row of the font. This hack means its OK to clip the bottom of the
-font, if the only thing that will be lost is the underscore.
-
-The `font_gen.py` program is based on the work by Jared Sanson (jared@jared.geek.nz).
-This program requires `PIL` (Python Imaging Library) to generate a `PNG` of the characters.
-The `PNG` is chunked to make the bitmaps for each character.
-Only the characters from SPACE (32) through Tilda (127) are rasterized.
-
---------------------------------------------------------------------------
---- */
-
-"""
-
-from PIL import Image, ImageFont, ImageDraw
-import os.path
-
-FONT_DIR = "./"
-
-# FONT = {'fname':r'font_file_name.ttf', 'def:'1,2,3, or 4', 'size':point_size, 'yoff':0, 'w':pixel_width, 'h':pixel_height}
-
-FONT6X8		= {'fname':r'HP100LX_6x8.ttf',		'def':'6X8',	'size':8,	'yoff':0,	'w':6,	'h':8}
-FONT8X14	= {'fname':r'ToshibaSat_8x14.ttf',	'def':'8X14',	'size':16,	'yoff':-2,	'w':8,	'h':12}
-FONT7X15	= {'fname':r'IBM_XGA-AI_7x15.ttf',	'def':'7X15',	'size':16,	'yoff':0,	'w':7,	'h':15}
-FONT12X23	= {'fname':r'IBM_XGA-AI_12x23.ttf',	'def':'12X23',	'size':24,	'yoff':-1,	'w':12,	'h':18}
-
-FONTS = [ FONT6X8, FONT8X14, FONT7X15, FONT12X23]
-
-
-# WARNING: Support for variable-width character fonts is not available
-
-for FONT in FONTS:
-	FONT_FILE = FONT['fname']
-	FONT_SIZE = FONT['size']
-	FONT_DEFINE = FONT.get('def', 'unknown')
-
-	FONT_Y_OFFSET = FONT.get('yoff', 0)
-
-	CHAR_WIDTH = FONT.get('w', 5)	# 5 is the default if the key value is missing
-	CHAR_HEIGHT = FONT.get('h', 8)	# 8 is the default if the key value is missing
-
-	# only get the character glyphs from SPACE through tilda
-	FONT_BEGIN = ' '
-	FONT_END = '~'
-
-
-	FONTSTR = ''.join(chr(x) for x in range(ord(FONT_BEGIN), ord(FONT_END)+1))
-
-	OUTPUT_NAME = 'font_' + FONT_DEFINE
-	OUTPUT_PNG = OUTPUT_NAME + '.png'
-	OUTPUT_H = OUTPUT_NAME + '.h'
-
-	GLYPH_WIDTH = CHAR_WIDTH
-
-	WIDTH = GLYPH_WIDTH * len(FONTSTR)
-	HEIGHT = CHAR_HEIGHT
-
-	img = Image.new("RGBA", (WIDTH, HEIGHT), (255,255,255))
-	fnt = ImageFont.truetype(FONT_DIR + FONT_FILE, FONT_SIZE)
-	drw = ImageDraw.Draw(img)
-
-	for i in range(len(FONTSTR)):
-		drw.text((i*GLYPH_WIDTH,FONT_Y_OFFSET), FONTSTR[i], (0,0,0), font=fnt)
-
-	img.save(OUTPUT_PNG)
-
-	#### Convert to C-header format
-	f = open(OUTPUT_H, 'w')
-	num_chars = len(FONTSTR)
-
-	f.write('\n')
-	f.write('// GENERATED FILE - DO NOT EDIT\n')
-	f.write('// To change fonts, edit and run python3 font_gen.py\n')
-	f.write('// generated from font file: "%s"\n' % (FONT_FILE))
-	f.write('\n')
-	# f.write('#define FONT_%s %s\n\n' % (FONT_DEFINE.upper(), FONT_DEFINE.upper()))
-	f.write('#define FONT_%s_WIDTH %d\n' % (FONT_DEFINE.upper(), CHAR_WIDTH))
-	f.write('#define FONT_%s_HEIGHT %d\n' % (FONT_DEFINE.upper(), CHAR_HEIGHT))
-	f.write('#define FONT_%s_WIDTHBYTES %d\n' % (FONT_DEFINE.upper(), int((CHAR_WIDTH + 7) / 8)))
-	f.write('#define FONT_%s_CHARBYTES %d\n' % (FONT_DEFINE.upper(), (int((CHAR_WIDTH + 7) / 8) * CHAR_HEIGHT)))
-	f.write('\n')
-	f.write('// NOTE: Data is width (bits) first by height (bits) to match the SRXE LCD processing.\n')
-	f.write('//       The bits are stored where the low bit is the left most pixel to be easier for SRXE processing.\n')
-	f.write('//       This has the positive of being flexible for any font and the negative of using more data space.\n')
-	f.write('//       Ideally for data size, the font width would be a multiple of 8, but LCD wants font width to be a multiple of 3.\n')
-	f.write('\n')
-
-	f.write('\nconst unsigned char font_' + FONT_DEFINE + '_P [] PROGMEM = {\n')
-
-	for i in range(num_chars):
-		ints = []
-
-		for y in range(CHAR_HEIGHT):
-			val = 0
-			x = 0
-			offset = i*GLYPH_WIDTH
-			shift = 0
-
-			for j in range(CHAR_WIDTH):
-				# if we are on the last row of the underscore, force the pixels
-				rgb = img.getpixel((j+offset,y))
-				if (y == (CHAR_HEIGHT - 1)) and (i == (95 - 32)) and (j != 0):
-					rgb = [0, 0, 0]
-				val = val | ((1 << shift) if rgb[0] < 127 else 0)
-				shift += 1
-				if shift % 8 == 0:
-					# store byte
-					ints.append('0x%.2x' % (val))
-					val = 0
-					shift = 0
-
-			if shift:
-				# we have bit(s) we have not stored
-				ints.append('0x%.2x' % (val))
-				val = 0
-				shift = 0
-
-		c = FONTSTR[i]
-		if c == '\\': c = '"\\"' # bugfix
-
-		f.write('\t%s, // %3d %s\n' % (','.join(ints), ord(c[0]), c))
-
-	f.write('\t%s\n' % (','.join(['0x00']*CHAR_WIDTH)))
-	f.write('};\n\n')
-
-	# f.write('FONTOBJECT font_%s_object = {font_%s_P, FONT_%s,  FONT_%s_WIDTH, FONT_%s_HEIGHT, FONT_%s_WIDTHBYTES, FONT_%s_CHARBYTES};\n' % (FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper()))
-	# f.write('\n')
-
-	f.close()
+"""
+
+/* ***************************************************************************
+* File:    font_gen.py
+* Date:    2021.08.10
+* Author:  Bradan Lane STUDIO
+*
+* This content may be redistributed and/or modified as outlined
+* under the MIT License
+*
+* ******************************************************************************/
+
+/* ---
+# SMART Response XE Font Generation
+
+Getting fonts to look good on the SRXE LCD is 25% trial and error, 33% subjective, 50% rendering engine, and 10% your code.
+
+This `font_gen.py` program generates header files that are specific to the SRXEcore text renderer. It was not written to
+match any previous format. The program will output a series of header files with bitmap data for a font at a designated W*H.
+The output data is _width first_ to match the way the rendering engine on the SRXEcore works.
+Also, _width first_ is how the LCD bitmap on a SRXE is formatted.
+
+The general workflow for generating new font files is as follows:
+ - find a font that will look good at the resolution you need. The best source is [Old School Fonts](https://int10h.org/oldschool-pc-fonts/)
+ - adjust the parameters (ID number, point size, y offset, width, and height) until the resulting `PNG` looks good
+ - include the generated header file(s) in your code
+
+The SRXEcore will compile out any rendering engine code not used so only include the generated headers you will actually use.
+
+### FONTS
+
+Only use monospace fonts. This code does not attempt to clean up and space out proportional fonts ... at least not very well.
+Ideally, the font width will be a multiple of 3. This will look best on the SRXE LCD display. The rendering engine will add whitespace
+between characters to pad out to the 3-pixel boundary required by the LCD driver.
+
+Fonts are somewhat subjective - especially at small sizes. Some people may have difficulty reading some fonts.
+Here are the best fonts I was able to find:
+
+|LABEL|WxH|DESCRIPTION|
+|:-----|:-----:|:-----|
+|TINY|6x8|The HP100LX is possible the best tiny font available|
+|SMALL|8x12|the Toshiba 8x14 can be tweeked quite a bit to make an excellent small font|
+|SMALL|9x15|the IBM XGA AI 7x15 is a clean contemporary looking font|
+|MEDIUM|12x18|the IBM XGA AI 12x23 makes a clean contemporary looking medium font|
+|LARGE|15x28|the IBM XGA AI 7x15 (doubled) actually looks a bit better that the 12x23|
+
+**Memory Usage:** If memory usage is a concern, the the `TINY` may be doubled to make a `MEDIUM` and the `SMALL` may be doubled to make a `LARGE`.
+The Toshiba font is better for doubling than the IBM font.
+
+_See the `lcdFontConfig()` and `lcdFontClone()` functions for details on doubling.
+
+### Native Fonts
+
+The standard output is 1 bit per pixel and the SRXEcore converts each character to LCD triplets when it is drawn.
+Adding `'native':True` to a font entry also writes a `font_<WxH>N.h` file with the characters already packed as
+LCD triplets and padded to the triplet boundary - exactly what the rendering engine would have produced.
+Native fonts are configured with the `FONT_<WxH>N_FLAGS` value as the `scale` of `lcdFontConfig()` and are streamed
+directly to the LCD with no conversion. They are always drawn at 1X.
+
+Adding `'grey':True` keeps the anti-aliased edges of the font as the 2-bit LCD grey levels.
+Greyscale native fonts carry their own shading and ignore the current colors.
+
+For each native font, the program reports the extra flash used against the conversion work saved per character.
+Use `benchGlyphs()` on the device to see the CPU cycles the conversion costs for a given font.
+
+### Notes
+
+Most fonts drop the underscore character to the very bottom of the font cell and below any other glyph pixels.
+This results in the need to make a font taller than it would otherwise need to be. For this reason, this program
+forces the underscore to the bottom most available row of the font. This hack means its OK to clip the bottom of the
+font, if the only thing that will be lost is the underscore.
+
+The `font_gen.py` program is based on the work by Jared Sanson (jared@jared.geek.nz).
+This program requires `PIL` (Python Imaging Library) to generate a `PNG` of the characters.
+The `PNG` is chunked to make the bitmaps for each character.
+Only the characters from SPACE (32) through Tilda (127) are rasterized.
+
+--------------------------------------------------------------------------
+--- */
+
+"""
+
+from PIL import Image, ImageFont, ImageDraw
+import os.path
+
+FONT_DIR = "./"
+
+# FONT = {'fname':r'font_file_name.ttf', 'def:'1,2,3, or 4', 'size':point_size, 'yoff':0, 'w':pixel_width, 'h':pixel_height}
+
+# optional: 'native':True to also generate the pre-packed LCD triplet format, 'grey':True for a 2-bit greyscale native font
+
+FONT6X8		= {'fname':r'HP100LX_6x8.ttf',		'def':'6X8',	'size':8,	'yoff':0,	'w':6,	'h':8}
+FONT8X14	= {'fname':r'ToshibaSat_8x14.ttf',	'def':'8X14',	'size':16,	'yoff':-2,	'w':8,	'h':12}
+FONT7X15	= {'fname':r'IBM_XGA-AI_7x15.ttf',	'def':'7X15',	'size':16,	'yoff':0,	'w':7,	'h':15}
+FONT12X23	= {'fname':r'IBM_XGA-AI_12x23.ttf',	'def':'12X23',	'size':24,	'yoff':-1,	'w':12,	'h':18}
+
+FONTS = [ FONT6X8, FONT8X14, FONT7X15, FONT12X23]
+
+
+# the LCD packs 3 pixels into a byte as bbxbbxbb; these must match lcdbase.h and the rendering engine in lcdtext.h
+TRIPLET_SIZE = 3
+LCD_WHITE = 0
+LCD_BLACK = 3
+
+def lcd_correct_color(c):
+	return 0xFF if c == 0xDB else c
+
+def native_row(levels):
+	# pack one row of pixel levels (0=white thru 3=black) as triplets, splitting a 2 pixel pad before and after
+	padding = (TRIPLET_SIZE - (len(levels) % TRIPLET_SIZE)) % TRIPLET_SIZE
+	if padding == 2:
+		levels = [LCD_WHITE] + levels + [LCD_WHITE]
+	else:
+		levels = levels + [LCD_WHITE] * padding
+	row = []
+	for t in range(0, len(levels), TRIPLET_SIZE):
+		row.append(lcd_correct_color((levels[t] << 6) | (levels[t+1] << 3) | levels[t+2]))
+	return row
+
+def pixel_level(rgb, grey):
+	# grey keeps the anti-aliasing as 4 levels; otherwise it is simply black or white
+	if grey:
+		return min(LCD_BLACK, ((255 - rgb[0]) * 4) // 256)
+	return LCD_BLACK if rgb[0] < 127 else LCD_WHITE
+
+
+# WARNING: Support for variable-width character fonts is not available
+
+for FONT in FONTS:
+	FONT_FILE = FONT['fname']
+	FONT_SIZE = FONT['size']
+	FONT_DEFINE = FONT.get('def', 'unknown')
+
+	FONT_Y_OFFSET = FONT.get('yoff', 0)
+
+	CHAR_WIDTH = FONT.get('w', 5)	# 5 is the default if the key value is missing
+	CHAR_HEIGHT = FONT.get('h', 8)	# 8 is the default if the key value is missing
+
+	# only get the character glyphs from SPACE through tilda
+	FONT_BEGIN = ' '
+	FONT_END = '~'
+
+
+	FONTSTR = ''.join(chr(x) for x in range(ord(FONT_BEGIN), ord(FONT_END)+1))
+
+	OUTPUT_NAME = 'font_' + FONT_DEFINE
+	OUTPUT_PNG = OUTPUT_NAME + '.png'
+	OUTPUT_H = OUTPUT_NAME + '.h'
+
+	GLYPH_WIDTH = CHAR_WIDTH
+
+	WIDTH = GLYPH_WIDTH * len(FONTSTR)
+	HEIGHT = CHAR_HEIGHT
+
+	img = Image.new("RGBA", (WIDTH, HEIGHT), (255,255,255))
+	fnt = ImageFont.truetype(FONT_DIR + FONT_FILE, FONT_SIZE)
+	drw = ImageDraw.Draw(img)
+
+	for i in range(len(FONTSTR)):
+		drw.text((i*GLYPH_WIDTH,FONT_Y_OFFSET), FONTSTR[i], (0,0,0), font=fnt)
+
+	img.save(OUTPUT_PNG)
+
+	#### Convert to C-header format
+	f = open(OUTPUT_H, 'w')
+	num_chars = len(FONTSTR)
+
+	f.write('\n')
+	f.write('// GENERATED FILE - DO NOT EDIT\n')
+	f.write('// To change fonts, edit and run python3 font_gen.py\n')
+	f.write('// generated from font file: "%s"\n' % (FONT_FILE))
+	f.write('\n')
+	# f.write('#define FONT_%s %s\n\n' % (FONT_DEFINE.upper(), FONT_DEFINE.upper()))
+	f.write('#define FONT_%s_WIDTH %d\n' % (FONT_DEFINE.upper(), CHAR_WIDTH))
+	f.write('#define FONT_%s_HEIGHT %d\n' % (FONT_DEFINE.upper(), CHAR_HEIGHT))
+	f.write('#define FONT_%s_WIDTHBYTES %d\n' % (FONT_DEFINE.upper(), int((CHAR_WIDTH + 7) / 8)))
+	f.write('#define FONT_%s_CHARBYTES %d\n' % (FONT_DEFINE.upper(), (int((CHAR_WIDTH + 7) / 8) * CHAR_HEIGHT)))
+	f.write('\n')
+	f.write('// NOTE: Data is width (bits) first by height (bits) to match the SRXE LCD processing.\n')
+	f.write('//       The bits are stored where the low bit is the left most pixel to be easier for SRXE processing.\n')
+	f.write('//       This has the positive of being flexible for any font and the negative of using more data space.\n')
+	f.write('//       Ideally for data size, the font width would be a multiple of 8, but LCD wants font width to be a multiple of 3.\n')
+	f.write('\n')
+
+	f.write('\nconst unsigned char font_' + FONT_DEFINE + '_P [] PROGMEM = {\n')
+
+	FONT_NATIVE = FONT.get('native', False)
+	FONT_GREY = FONT.get('grey', False)
+	native_glyphs = []
+
+	for i in range(num_chars):
+		ints = []
+		native = []
+
+		for y in range(CHAR_HEIGHT):
+			val = 0
+			x = 0
+			offset = i*GLYPH_WIDTH
+			shift = 0
+			levels = []
+
+			for j in range(CHAR_WIDTH):
+				# if we are on the last row of the underscore, force the pixels
+				rgb = img.getpixel((j+offset,y))
+				if (y == (CHAR_HEIGHT - 1)) and (i == (95 - 32)) and (j != 0):
+					rgb = [0, 0, 0]
+				val = val | ((1 << shift) if rgb[0] < 127 else 0)
+				levels.append(pixel_level(rgb, FONT_GREY))
+				shift += 1
+				if shift % 8 == 0:
+					# store byte
+					ints.append('0x%.2x' % (val))
+					val = 0
+					shift = 0
+
+			if shift:
+				# we have bit(s) we have not stored
+				ints.append('0x%.2x' % (val))
+				val = 0
+				shift = 0
+
+			native.extend(native_row(levels))
+
+		native_glyphs.append(native)
+
+		c = FONTSTR[i]
+		if c == '\\': c = '"\\"' # bugfix
+
+		f.write('\t%s, // %3d %s\n' % (','.join(ints), ord(c[0]), c))
+
+	f.write('\t%s\n' % (','.join(['0x00']*CHAR_WIDTH)))
+	f.write('};\n\n')
+
+	# f.write('FONTOBJECT font_%s_object = {font_%s_P, FONT_%s,  FONT_%s_WIDTH, FONT_%s_HEIGHT, FONT_%s_WIDTHBYTES, FONT_%s_CHARBYTES};\n' % (FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper(), FONT_DEFINE.upper()))
+	# f.write('\n')
+
+	f.close()
+
+	if not FONT_NATIVE:
+		continue
+
+	#### Write the native (pre-packed LCD triplet) format
+	NATIVE_DEFINE = FONT_DEFINE + 'N'
+	TRIPLETS = int((CHAR_WIDTH + TRIPLET_SIZE - 1) / TRIPLET_SIZE)
+	NATIVE_CHARBYTES = TRIPLETS * CHAR_HEIGHT
+
+	f = open('font_' + NATIVE_DEFINE + '.h', 'w')
+	f.write('\n')
+	f.write('// GENERATED FILE - DO NOT EDIT\n')
+	f.write('// To change fonts, edit and run python3 font_gen.py\n')
+	f.write('// generated from font file: "%s"\n' % (FONT_FILE))
+	f.write('\n')
+	f.write('#define FONT_%s_WIDTH %d\n' % (NATIVE_DEFINE.upper(), CHAR_WIDTH))
+	f.write('#define FONT_%s_HEIGHT %d\n' % (NATIVE_DEFINE.upper(), CHAR_HEIGHT))
+	f.write('#define FONT_%s_WIDTHBYTES %d\n' % (NATIVE_DEFINE.upper(), TRIPLETS))
+	f.write('#define FONT_%s_CHARBYTES %d\n' % (NATIVE_DEFINE.upper(), NATIVE_CHARBYTES))
+	f.write('#define FONT_%s_FLAGS %s\n' % (NATIVE_DEFINE.upper(), '(FONT_NATIVE | FONT_GREYSCALE)' if FONT_GREY else 'FONT_NATIVE'))
+	f.write('\n')
+	f.write('// NOTE: Data is LCD triplets (3 pixels per byte) by height (rows), exactly as sent to the SRXE LCD.\n')
+	f.write('//       Each row is padded to the triplet boundary. %s\n' % ('Pixels are 2-bit grey levels.' if FONT_GREY else 'Pixels are LCD_BLACK on LCD_WHITE.'))
+	f.write('\n')
+
+	f.write('\nconst unsigned char font_' + NATIVE_DEFINE + '_P [] PROGMEM = {\n')
+	for i in range(num_chars):
+		c = FONTSTR[i]
+		if c == '\\': c = '"\\"' # bugfix
+		f.write('\t%s, // %3d %s\n' % (','.join('0x%.2x' % (b) for b in native_glyphs[i]), ord(c[0]), c))
+	f.write('};\n\n')
+	f.close()
+
+	# report the flash cost against the conversion which is no longer needed when drawing
+	bitmap_bytes = (int((CHAR_WIDTH + 7) / 8) * CHAR_HEIGHT * num_chars) + CHAR_WIDTH
+	native_bytes = NATIVE_CHARBYTES * num_chars
+	print('%s: 1-bit %d bytes, native %d bytes (%+d bytes flash); saves converting %d pixels into %d triplets per character' %
+		('font_' + NATIVE_DEFINE, bitmap_bytes, native_bytes, native_bytes - bitmap_bytes, CHAR_WIDTH * CHAR_HEIGHT, NATIVE_CHARBYTES))
@@ -0,0 +1,106 @@
+/* ************************************************************************************
+* File:    ring_bench.c
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/*
+	Host throughput benchmark for the circular buffers of src/cbuffer.h
+
+	Moves the same data through a 128 byte buffer, in frame sized pieces as the RF byte functions do, using:
+	- the cBuffer bufferPut() / bufferGet() loop
+	- the cRing ringPut() / ringGet() loop
+	- the cRing span functions, via ringWrite() / ringRead()
+
+	The AVR critical section is reduced to reading and writing a volatile SREG, so the cBuffer figures flatter it
+	compared with the device, where cli() and the SREG restore cost real cycles on every byte.
+
+	build and run:
+		gcc -O2 -o ring_bench files/ring_bench.c && ./ring_bench
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// just enough of the AVR environment for cbuffer.h
+#define CHIP_ATMEGA128RFA1
+volatile unsigned char SREG;
+static inline void cli() { SREG = 0; }
+static inline void _delay_ms(int ms) { (void)ms; }
+
+#include "../src/cbuffer.h"
+
+#define BUFFER_SIZE	128
+#define PIECE		100				// bytes written and then read each time; about one frame
+#define TOTAL		(64UL << 20)	// bytes moved by each method
+
+static uint8_t memory[BUFFER_SIZE];
+static uint8_t source[PIECE], sink[PIECE];
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+static void report(const char *name, double seconds, uint32_t check) {
+	printf("%-24s %8.1f MB/s  %6.2f ns/byte  (check %08x)\n", name, (TOTAL / seconds) / 1e6, (seconds * 1e9) / TOTAL, check);
+}
+
+static uint32_t checksum(uint32_t sum) {
+	for (int i = 0; i < PIECE; i++)
+		sum = (sum * 31) + sink[i];
+	return sum;
+}
+
+int main() {
+	double start;
+	uint32_t check;
+
+	for (int i = 0; i < PIECE; i++)
+		source[i] = i;
+
+	cBuffer buffer;
+	bufferReset(&buffer, memory, BUFFER_SIZE);
+	check = 0;
+	start = now();
+	for (unsigned long moved = 0; moved < TOTAL; moved += PIECE) {
+		for (int i = 0; i < PIECE; i++)
+			bufferPut(&buffer, source[i]);
+		for (int i = 0; i < PIECE; i++)
+			sink[i] = bufferGet(&buffer);
+		check = checksum(check);
+	}
+	report("bufferPut/bufferGet", now() - start, check);
+
+	cRing ring;
+	ringReset(&ring, memory, BUFFER_SIZE);
+	check = 0;
+	start = now();
+	for (unsigned long moved = 0; moved < TOTAL; moved += PIECE) {
+		for (int i = 0; i < PIECE; i++)
+			ringPut(&ring, source[i]);
+		for (int i = 0; i < PIECE; i++)
+			sink[i] = ringGet(&ring);
+		check = checksum(check);
+	}
+	report("ringPut/ringGet", now() - start, check);
+
+	ringReset(&ring, memory, BUFFER_SIZE);
+	check = 0;
+	start = now();
+	for (unsigned long moved = 0; moved < TOTAL; moved += PIECE) {
+		ringWrite(&ring, source, PIECE);
+		ringRead(&ring, sink, PIECE);
+		check = checksum(check);
+	}
+	report("ringWrite/ringRead span", now() - start, check);
+
+	return 0;
+}
@@ -38,6 +38,7 @@ The following AVR headers and standard headers are used by the SRXE library func
 #include <avr/sleep.h>		// needed for the power functions
 #include <util/atomic.h>
 #include <util/delay.h>
+#include <util/crc16.h>		// needed for the FLASH log record checks
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -61,14 +61,26 @@ The following order of SRXE functions is recommended:
 #include "power.h"      // handles sleep mode and battery status
 #include "eeprom.h"     // access to EEPROM storage
 #include "flash.h"      // access to the tiny 128KB FLASH chip
+#include "flashread.h"  // (optional) streamed FLASH reads and a page cache
+#include "flashjob.h"   // (optional) FLASH erases and writes which do not wait (requires clock)
+#include "flashlog.h"   // (optional) append-only log of records on the FLASH chip (requires clock)
 #include "rf.h"         // RF Transceiver I/O
+#include "rfmsg.h"      // (optional) messages larger than one frame (requires RF and clock)
+#include "rfchannel.h"  // (optional) channel survey and group channel changes (requires RF)
+#include "rflpl.h"      // (optional) low power listening; the radio sleeps between messages (requires RF and clock)
+#include "rfmesh.h"     // (optional) messages relayed across several devices (requires RF, clock, and EEPROM)
+#include "rfsecure.h"   // (optional) encrypted and authenticated frames (requires RF and EEPROM)
+#include "rfpower.h"    // (optional) transmit power adapted to each neighbour (requires RF)
 #include "random.h"     // pseudo random number generator (must be after RF)
 #include "lcdbase.h"    // the supporting functions for the remaining LCD functions
+#include "lcddefer.h"   // (optional) deferred drawing; send each frame to the LCD once
 #include "lcddraw.h"    // the basic draw primatives
 #include "lcdtext.h"    // text output to the LCD
 #include "keyboard.h"   // Keyboard scanning
 #include "ui.h"      	// composite UI elements (requires LCD and keyboard)
 
+#include "benchmark.h"  // (optional) CPU cycle measurements and on-device benchmarks
+
 #include "printf.h"     // tiny printf() capabilities with selectable output targets (RF, LCD, or UART)
 /*
 ```
@@ -76,6 +88,7 @@ You may include only what you will use.
 
 **Note:** To include the UART and LED functions define `SRXECORE_DEBUG` before including the library header files.
 Otherwise, the UART and LED functions will be compiled out.
+Likewise, define `SRXE_BENCHMARK` to include the benchmark functions.
 
 Including them all will not increase your final code size if you are not using the functions.
 
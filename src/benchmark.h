@@ -0,0 +1,655 @@
+/* ************************************************************************************
+* File:    benchmark.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+## Benchmark
+**CPU Cycle Measurements for Performance Work**
+
+The benchmark module uses TIMER1, running at the CPU clock with no prescaler, to count the exact number
+of CPU cycles taken by a block of code. The 16 bit counter is extended to 32 bits with the overflow interrupt.
+
+The module also contains the on-device benchmarks for the library. Each benchmark reports its results
+using `printDevicePrintf()` so they may be sent to the LCD, the UART, or over RF.
+
+**Note:** To include the benchmark functions define `SRXE_BENCHMARK` before including the library header files.
+Otherwise, the benchmark functions will be compiled out.
+
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_BENCHMARK_
+#define __SRXE_BENCHMARK_
+
+#ifdef SRXE_BENCHMARK
+
+volatile uint16_t _bench_overflows;	// upper 16 bits of the cycle counter
+uint32_t _bench_start;				// cycle count when benchStart() was called
+uint32_t _bench_overhead;			// cycles consumed by reading the counter; subtracted from every measurement
+
+ISR(TIMER1_OVF_vect) {
+	_bench_overflows++;
+}
+
+// return the current 32 bit cycle count
+static uint32_t _bench_cycles() {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t low = TCNT1;
+	uint16_t high = _bench_overflows;
+	// an overflow may be pending if the counter wrapped after interrupts were disabled
+	if ((TIFR1 & (1 << TOV1)) && (low < 0x8000))
+		high++;
+	SREG = sreg;
+	return ((uint32_t)high << 16) | low;
+}
+
+/* ---
+#### void benchStart()
+
+Start a cycle measurement. The first call also initializes TIMER1.
+--- */
+
+void benchStart() {
+	if (!(TCCR1B & ((1 << CS12) | (1 << CS11) | (1 << CS10)))) {
+		TCCR1A = 0;								// normal mode
+		TCCR1B = (1 << CS10);					// no prescaler; one count per CPU cycle
+		TCNT1 = 0;
+		_bench_overflows = 0;
+		TIFR1 = (1 << TOV1);					// clear any pending overflow
+		TIMSK1 |= (1 << TOIE1);					// enable the overflow interrupt
+		sei();
+
+		// measure back-to-back reads so the cost may be subtracted from every measurement
+		uint32_t first = _bench_cycles();
+		_bench_overhead = _bench_cycles() - first;
+	}
+	_bench_start = _bench_cycles();
+}
+
+
+/* ---
+#### uint32_t benchStop()
+
+Return the number of CPU cycles since the matching `benchStart()`.
+The cost of the measurement itself has been subtracted.
+--- */
+
+uint32_t benchStop() {
+	uint32_t cycles = _bench_cycles() - _bench_start;
+	return (cycles > _bench_overhead) ? (cycles - _bench_overhead) : 0;
+}
+
+// --------------------------------------------------------------------------------------------
+// Glyph conversion benchmark
+//
+// The original conversion loop built each triplet one pixel at a time and only supported 1X and 2X scaling.
+// It is kept here, unchanged, so the current kernel may be compared against it on the device.
+
+static bool _bench_legacy_glyph_render(FONTOBJECT *font, char c, uint8_t fg, uint8_t bg, uint8_t *lcd_bitmap, uint16_t lcd_bitmap_size) {
+	uint8_t font_width = font->width;
+	uint8_t font_multiplier_width = ((font->scale & FONT_DOUBLE_WIDTH) ? 2 : 1);
+	uint8_t glyph_width = font_width * font_multiplier_width;
+	uint8_t font_multiplier_height = ((font->scale & FONT_DOUBLE_HEIGHT) ? 2 : 1);
+	uint8_t font_widthbytes = font->widthbytes;
+	uint8_t font_charbytes = font->charbytes;
+
+	uint8_t padding = TRIPLET_OFFSET(glyph_width);
+
+	uint8_t *bp, bp_counter;
+	uint8_t font_bytes[font_charbytes], *cp, cb, cb_multiplier_width, cb_multiplier_height;
+	uint8_t triplet;
+	uint8_t pixel;
+
+	bp = lcd_bitmap;
+	bp_counter = 0;
+	cb_multiplier_width = cb_multiplier_height = 1;
+
+	cp = (unsigned char *)&(font->data[(c - 32) * (font_charbytes)]);
+	memcpy_P(font_bytes, cp, font_charbytes);
+	cp = font_bytes;
+	cb = cp[0];
+
+	for (int j = 0; j < font_charbytes;) {
+		triplet = bg;
+		pixel = 0;
+
+		if (padding == 2) {
+			triplet <<= 3;
+			triplet &= 0b11111000;
+			triplet |= bg;
+			pixel++;
+		}
+
+		for (int k = 0; k < (font_width * font_multiplier_width); k++) {
+			if (pixel && !(pixel % TRIPLET_SIZE)) {
+				triplet = LCD_CORRECT_COLOR(triplet);
+				*bp = triplet;
+				bp++;
+				triplet = bg;
+				bp_counter++;
+				if (bp_counter >= lcd_bitmap_size) {
+					return false;
+				}
+			}
+
+			if (k && !(k % (8 * font_multiplier_width))) {
+				j++;
+				cb = cp[j];
+			}
+
+			triplet <<= TRIPLET_SIZE;
+			triplet &= 0b11111000;
+			triplet |= (cb & 0x1) ? fg : bg;
+			pixel++;
+
+			if (cb_multiplier_width < font_multiplier_width) {
+				cb_multiplier_width++;
+			} else {
+				cb_multiplier_width = 1;
+				cb = cb >> 1;
+			}
+		}
+
+		if (padding) {
+			triplet <<= 3;
+			triplet &= 0b11111000;
+			triplet |= bg;
+		}
+		triplet = LCD_CORRECT_COLOR(triplet);
+		*bp = triplet;
+		bp++;
+		bp_counter++;
+		j++;
+
+		if (cb_multiplier_height < font_multiplier_height) {
+			cb_multiplier_height++;
+			j -= font_widthbytes;
+		} else {
+			cb_multiplier_height = 1;
+		}
+
+		cb = cp[j];
+	}
+
+	return true;
+}
+
+#define BENCH_GLYPH_BUFFER 160	// large enough for the biggest built-in font (FONT4 = 6 triplets x 24 rows) at its default scale
+
+/* ---
+#### void benchGlyphs(uint8_t device)
+
+Report the average CPU cycles to convert one character for each of the built-in fonts,
+using the original conversion loop and the current lookup table kernel.
+Native fonts are streamed without conversion and are simply listed.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The glyph cache is bypassed so only the conversion is measured.
+--- */
+
+void benchGlyphs(uint8_t device) {
+	uint8_t buffer[BENCH_GLYPH_BUFFER];
+	uint32_t legacy, current;
+
+	for (uint8_t f = 0; f < FONTS_MAX; f++) {
+		FONTOBJECT *font = &(_srxe_fonts[f]);
+
+		if (font->scale & FONT_NATIVE) {
+			printDevicePrintf(device, "FONT%d %dx%d: native, no conversion\n", f + 1, font->width, font->height);
+			continue;
+		}
+
+		legacy = 0;
+		current = 0;
+		for (char c = ' '; c <= '~'; c++) {
+			benchStart();
+			_bench_legacy_glyph_render(font, c, LCD_BLACK, LCD_WHITE, buffer, sizeof(buffer));
+			legacy += benchStop();
+
+			benchStart();
+			_lcd_glyph_render(font, c, LCD_BLACK, LCD_WHITE, buffer, sizeof(buffer));
+			current += benchStop();
+		}
+		legacy /= ('~' - ' ' + 1);
+		current /= ('~' - ' ' + 1);
+
+		printDevicePrintf(device, "FONT%d %dx%d: %lu -> %lu cycles/glyph\n", f + 1,
+						  font->width * FONT_SCALE_WIDTH(font->scale),
+						  font->height * FONT_SCALE_HEIGHT(font->scale), legacy, current);
+	}
+}
+
+
+// --------------------------------------------------------------------------------------------
+// Screen clear benchmark
+//
+// The original fill sent the screen one row at a time from a RAM buffer, selecting the LCD for each row.
+
+static void _bench_legacy_fill(uint8_t ucData) {
+	uint8_t temp[128];
+
+	_lcd_set_active_area(0, 0, LCD_WIDTH, LCD_HEIGHT);
+	for (int y = 0; y < LCD_HEIGHT; y++) {
+		memset(temp, ucData, LCD_WIDTH);
+		_lcd_write_data_block(temp, LCD_WIDTH);
+	}
+	_lcd_end_active_area();
+}
+
+/* ---
+#### void benchClear(uint8_t device)
+
+Report the CPU cycles, and the time in microseconds, for a full screen clear (17,408 bytes)
+using the original row by row fill and the current burst fill.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The screen is cleared to the current background color; anything on the LCD is lost.
+--- */
+
+void benchClear(uint8_t device) {
+	uint8_t color = _lcd_color_to_byte[_lcd_color_bg];
+	uint32_t legacy, current;
+
+	benchStart();
+	_bench_legacy_fill(color);
+	legacy = benchStop();
+
+	benchStart();
+	lcdFill(color);
+	current = benchStop();
+
+	printDevicePrintf(device, "clear: %lu -> %lu cycles\n", legacy, current);
+	printDevicePrintf(device, "clear: %lu -> %lu us\n", legacy / (F_CPU / 1000000UL), current / (F_CPU / 1000000UL));
+}
+
+
+// --------------------------------------------------------------------------------------------
+// Pin I/O benchmark
+//
+// The original pin functions always decoded the pin code at runtime; they remain available as the
+// _srxe_pin_mode(), _srxe_digital_write(), and _srxe_digital_read() functions.
+
+static void _bench_legacy_write_data_block(uint8_t* data, uint16_t len) {
+	_srxe_digital_write(LCD_CS, LOW);
+	for (uint16_t i = 0; i < len; i++)
+		_srxe_spi_transfer(data[i]);
+	_srxe_digital_write(LCD_CS, HIGH);
+}
+
+static void _bench_legacy_scan_matrix() {
+	for (uint8_t col = 0; col < COLS; col++) {
+		_new_keymap[col] = 0;
+		_srxe_pin_mode(_kb_col_pins[col], OUTPUT);
+		_srxe_digital_write(_kb_col_pins[col], LOW);
+		for (uint8_t row = 0; row < ROWS; row++) {
+			if (_srxe_digital_read(_kb_row_pins[row]) == LOW)
+				_new_keymap[col] |= (1 << row);
+		}
+		_srxe_digital_write(_kb_col_pins[col], HIGH);
+		_srxe_pin_mode(_kb_col_pins[col], INPUT);
+	}
+}
+
+/* ---
+#### void benchPins(uint8_t device)
+
+Report the CPU cycles for an LCD data block write (one 128 byte row) and for a full keyboard scan,
+using the runtime pin decoding and the constant pin codes.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The data block is written to the top row of the screen, which is cleared to the background color.
+The keyboard scan includes the `KBD_SETTLE_US` delay for each column.
+--- */
+
+void benchPins(uint8_t device) {
+	uint8_t buffer[LCD_WIDTH];
+	uint32_t legacy, current;
+
+	memset(buffer, _lcd_color_to_byte[_lcd_color_bg], sizeof(buffer));
+
+	_lcd_set_active_area(0, 0, LCD_WIDTH, 1);
+	benchStart();
+	_bench_legacy_write_data_block(buffer, sizeof(buffer));
+	legacy = benchStop();
+	_lcd_end_active_area();
+
+	_lcd_set_active_area(0, 0, LCD_WIDTH, 1);
+	benchStart();
+	_lcd_write_data_block(buffer, sizeof(buffer));
+	current = benchStop();
+	_lcd_end_active_area();
+
+	printDevicePrintf(device, "data block: %lu -> %lu cycles\n", legacy, current);
+
+	benchStart();
+	_bench_legacy_scan_matrix();
+	legacy = benchStop();
+
+	benchStart();
+	_kbd_scan_matrix();
+	current = benchStop();
+
+	printDevicePrintf(device, "kbd scan: %lu -> %lu cycles\n", legacy, current);
+}
+
+
+// --------------------------------------------------------------------------------------------
+// RF security benchmark
+//
+// A plain frame is copied once each way: into the transmit queue, and from the frame buffer into the receive ring.
+// A secure frame is encrypted and decrypted during the same copies.
+
+static const uint8_t _bench_secure_sizes[] = {16, 48, RF_SECURE_PAYLOAD_SIZE};
+
+/* ---
+#### void benchSecure(uint8_t device)
+
+Report the CPU cycles per frame to queue a frame to be sent, and to store a received frame,
+without and with security, for several sizes of data.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The RF transceiver must be inited and security must be on; see `rfSecureSet()`.
+The frames are sent. Received frames are made from the data rather than received; anything in the receive ring is dropped.
+--- */
+
+void benchSecure(uint8_t device) {
+	uint8_t data[RF_FRAME_PAYLOAD_SIZE];
+	uint8_t frame[RF_FRAME_PAYLOAD_SIZE];
+	uint32_t plain, secure;
+
+	if (!rfInited() || !_rf_secure_on) {
+		printDevicePrintf(device, "secure: RF and security must be on\n");
+		return;
+	}
+
+	for (uint8_t i = 0; i < sizeof(data); i++)
+		data[i] = 'a' + (i % 26);
+	while (rfReceiveFrame())
+		rfReleaseFrame();
+
+	for (uint8_t i = 0; i < sizeof(_bench_secure_sizes); i++) {
+		uint8_t length = _bench_secure_sizes[i];
+
+		while (rfSendQueueDepth())
+			;
+		benchStart();
+		if (_rf_extended)
+			rfSendTo(RF_BROADCAST, data, length);
+		else
+			rfSendFrame(data, length);
+		plain = benchStop();
+
+		while (rfSendQueueDepth())
+			;
+		benchStart();
+		rfSecureSend(RF_BROADCAST, data, length);
+		secure = benchStop();
+
+		printDevicePrintf(device, "secure tx %3d: %lu -> %lu cycles\n", length, plain, secure);
+
+		// a secure frame as another device would send it
+		uint32_t counter = ++_rf_secure_counter;
+		frame[0] = RF_PROTOCOL_SECURE;
+		memcpy(&(frame[1]), "BENCH!", EEPROM_ID_SIZE);
+		memcpy(&(frame[1 + EEPROM_ID_SIZE]), &counter, sizeof(counter));
+		_rf_secure_crypt(&(frame[1]), data, &(frame[RF_SECURE_HEADER_SIZE]), length, true, &(frame[RF_SECURE_HEADER_SIZE + length]));
+
+		uint8_t sreg = SREG;
+		cli();
+		benchStart();
+		RFFRAME *slot = _rf_rx_reserve();
+		if (slot) {
+			memcpy(slot->data, data, length);
+			_rf_rx_commit(length);
+		}
+		plain = benchStop();
+		SREG = sreg;
+		rfReleaseFrame();
+
+		cli();
+		benchStart();
+		_rf_secure_handler(frame, RF_SECURE_HEADER_SIZE + length + RF_SECURE_MIC_SIZE, RF_ADDRESS_NONE);
+		secure = benchStop();
+		SREG = sreg;
+		rfReleaseFrame();
+
+		printDevicePrintf(device, "secure rx %3d: %lu -> %lu cycles\n", length, plain, secure);
+	}
+}
+
+
+// --------------------------------------------------------------------------------------------
+// FLASH log latency benchmark
+//
+// A main loop which only runs the FLASH jobs, over one erase of the log's spare sector. The spare sector holds no records,
+// so a page of it is written first to give the erase real work, and the log's records are never touched.
+
+/* ---
+#### void benchFlash(uint8_t device)
+
+Report the longest pass through a main loop, in CPU cycles and microseconds, over one erase of the FLASH log's spare sector,
+and how long that erase took; without FLASH jobs the loop would have stalled for all of it.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The FLASH log must be inited; see `flashLogInit()`. Only the spare sector is used; it is erased again before this returns.
+--- */
+
+void benchFlash(uint8_t device) {
+	uint8_t data[100];
+	uint32_t cycles, longest = 0;
+	uint32_t loops = 0, erase_ms = 0;
+
+	if (!_flash_log_inited) {
+		printDevicePrintf(device, "flash: the log must be inited\n");
+		return;
+	}
+	for (uint8_t i = 0; i < sizeof(data); i++)
+		data[i] = 'a' + (i % 26);
+
+	flashLogPoll();
+	flashJobFinish();
+	uint8_t spare = _FLASH_LOG_NEXT(_flash_log_head);
+	if (_flash_log_state[spare] != _FLASH_LOG_FREE) {
+		printDevicePrintf(device, "flash: the spare sector is not erased\n");
+		return;
+	}
+
+	// until it is erased again the spare sector must not be used by the log
+	_flash_log_state[spare] = _FLASH_LOG_DIRTY;
+	flashJobWrite(_FLASH_LOG_ADDRESS(spare), data, sizeof(data), NULL);
+	flashJobFinish();
+	_flash_log_erase(spare);
+
+	uint32_t started = clockMillis();
+	while (_flash_log_state[spare] == _FLASH_LOG_ERASING) {
+		benchStart();
+		flashJobPoll();
+		flashLogPoll();
+		cycles = benchStop();
+		loops++;
+		if (cycles > longest)
+			longest = cycles;
+	}
+	erase_ms = clockMillis() - started;
+
+	printDevicePrintf(device, "flash gc: %lu loops, longest %lu cycles (%lu us), erase %lu ms\n",
+		loops, longest, longest / (F_CPU / 1000000L), erase_ms);
+}
+
+
+// --------------------------------------------------------------------------------------------
+// FLASH read benchmark
+//
+// The same bytes are read in small pieces by SRXEFlashRead(), which sends a command and address each time,
+// and by a FLASHREADER, which streams. Then small reads jump about within a few pages, with and without the page cache.
+
+#define BENCH_FLASH_READ_BYTES	8192L
+#define BENCH_FLASH_READ_PIECE	16
+#define BENCH_FLASH_LOOKUPS		1024
+#define BENCH_FLASH_LOOKUP_SIZE	4
+
+// KB/s from the bytes read in a number of CPU cycles
+static uint32_t _bench_kbs(uint32_t bytes, uint32_t cycles) {
+	return cycles ? ((bytes * (F_CPU / 1024)) / cycles) : 0;
+}
+
+/* ---
+#### void benchFlashRead(uint8_t device)
+
+Report the read throughput of the FLASH chip, in KB/s, for reads of a few bytes at a time:
+one command per read, a streaming `FLASHREADER`, and lookups which jump about within `FLASH_CACHE_PAGES` + 1 pages
+without and with the page cache, along with the cache hit rate.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The FLASH chip is only read. Any FLASH jobs are finished first.
+--- */
+
+void benchFlashRead(uint8_t device) {
+	uint8_t data[BENCH_FLASH_READ_PIECE];
+	uint32_t single, stream, plain, cached;
+	FLASHREADER reader;
+
+	flashJobFinish();
+
+	benchStart();
+	for (uint32_t addr = 0; addr < BENCH_FLASH_READ_BYTES; addr += sizeof(data))
+		SRXEFlashRead(addr, data, sizeof(data));
+	single = benchStop();
+
+	benchStart();
+	flashReaderOpen(&reader, 0);
+	for (uint32_t addr = 0; addr < BENCH_FLASH_READ_BYTES; addr += sizeof(data))
+		flashReaderRead(&reader, data, sizeof(data));
+	stream = benchStop();
+	flashReaderClose(&reader);
+
+	printDevicePrintf(device, "flash read %d: %lu -> %lu KB/s\n", BENCH_FLASH_READ_PIECE,
+		_bench_kbs(BENCH_FLASH_READ_BYTES, single), _bench_kbs(BENCH_FLASH_READ_BYTES, stream));
+
+	// the same addresses for both; a simple LCG keeps them repeatable
+	uint16_t seed = 1;
+	uint16_t span = (FLASH_CACHE_PAGES + 1) * FLASH_PAGE_SIZE;
+	benchStart();
+	for (uint16_t i = 0; i < BENCH_FLASH_LOOKUPS; i++) {
+		seed = (seed * 25173) + 13849;
+		SRXEFlashRead(seed % (span - BENCH_FLASH_LOOKUP_SIZE), data, BENCH_FLASH_LOOKUP_SIZE);
+	}
+	plain = benchStop();
+
+	seed = 1;
+	flashCacheHitRate(true);
+	benchStart();
+	for (uint16_t i = 0; i < BENCH_FLASH_LOOKUPS; i++) {
+		seed = (seed * 25173) + 13849;
+		flashCacheRead(seed % (span - BENCH_FLASH_LOOKUP_SIZE), data, BENCH_FLASH_LOOKUP_SIZE);
+	}
+	cached = benchStop();
+
+	printDevicePrintf(device, "flash lookup %d: %lu -> %lu KB/s, %d%% hits\n", BENCH_FLASH_LOOKUP_SIZE,
+		_bench_kbs((uint32_t)BENCH_FLASH_LOOKUPS * BENCH_FLASH_LOOKUP_SIZE, plain),
+		_bench_kbs((uint32_t)BENCH_FLASH_LOOKUPS * BENCH_FLASH_LOOKUP_SIZE, cached), flashCacheHitRate(true));
+}
+
+
+// --------------------------------------------------------------------------------------------
+// EEPROM ID benchmark
+//
+// The original eepromAddID() compared the new ID with every stored ID, one EEPROM byte at a time.
+// Its search is kept here so the indexed lookup may be compared with it at several numbers of stored IDs.
+
+static bool _bench_legacy_id_scan(const char *code, uint8_t count) {
+	for (uint8_t slot_num = 0; slot_num < count; slot_num++) {
+		uint16_t slot_start = EEPROM_ID_STORAGE + (slot_num * EEPROM_ID_SIZE);
+		bool matched = true;
+		for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
+			if (code[i] != eepromReadByte(slot_start + i))
+				matched = false;
+		if (matched)
+			return true;
+	}
+	return false;
+}
+
+// a made-up ID for each number
+static void _bench_id(uint16_t n, char *code) {
+	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++) {
+		code[i] = 'a' + (n % 26);	// lower case so they are never a real signature
+		n /= 26;
+	}
+}
+
+static const uint8_t _bench_id_counts[] = {10, 100, EEPROM_ID_SLOTS};
+
+/* ---
+#### void benchIDs(uint8_t device)
+
+Report the CPU cycles to look up an ID with 10, 100, and `EEPROM_ID_SLOTS` (170, a full table) IDs stored:
+an ID which is not stored, with the original scan and with `eepromHasID()`, and a stored ID, the first time and once it is recent.
+
+- uint8_t device - `PRINT_LCD`, `PRINT_RF`, or `PRINT_UART`
+
+**Note:** The stored IDs are replaced by made-up IDs, which are cleared at the end. Storing them takes about 20ms per ID.
+--- */
+
+void benchIDs(uint8_t device) {
+	char code[EEPROM_ID_SIZE];
+	uint32_t legacy, missing, stored, recent;
+
+	for (uint8_t i = 0; i < sizeof(_bench_id_counts); i++) {
+		uint8_t count = _bench_id_counts[i];
+
+		eepromClearIDs();
+		for (uint8_t n = 0; n < count; n++) {
+			_bench_id(n, code);
+			eepromAddID(code);
+		}
+
+		_bench_id(1000, code);
+		benchStart();
+		_bench_legacy_id_scan(code, count);
+		legacy = benchStop();
+		benchStart();
+		eepromHasID(code);
+		missing = benchStop();
+
+		_bench_id(0, code);		// the recent IDs are the last ones stored
+		benchStart();
+		eepromHasID(code);
+		stored = benchStop();
+		benchStart();
+		eepromHasID(code);
+		recent = benchStop();
+
+		printDevicePrintf(device, "ids %3d: missing %lu -> %lu, stored %lu, recent %lu cycles\n", count, legacy, missing, stored, recent);
+	}
+	eepromClearIDs();
+}
+
+#else // SRXE_BENCHMARK
+
+#define benchStart()
+#define benchStop()		(0)
+#define benchGlyphs(d)
+#define benchClear(d)
+#define benchPins(d)
+#define benchSecure(d)
+#define benchFlash(d)
+#define benchFlashRead(d)
+#define benchIDs(d)
+
+#endif // SRXE_BENCHMARK
+
+#endif // __SRXE_BENCHMARK_
@@ -170,4 +170,132 @@ void bufferFlush(cBuffer *buffer) {
 	CRITICAL_SECTION_END;
 }
 
+
+// --------------------------------------------------------------------------
+// cRing - single producer, single consumer ring
+//
+// The producer only writes 'head' and the consumer only writes 'tail', so an interrupt may fill the ring while the
+// program empties it (or the reverse) without a critical section. The indices run freely and are masked on use,
+// so the size must be a power of 2 and, for the 8 bit indices to be read atomically, no more than 128 bytes.
+// The span functions expose the contiguous part of the data, or of the free space, for memcpy() style transfers.
+
+// keeps the compiler from moving the data access to the other side of the index update
+#define _RING_BARRIER()	__asm__ __volatile__("" ::: "memory")
+
+typedef struct struct_cRing {
+	uint8_t *data;				// the physical memory for the ring
+	uint8_t mask;				// the size of the ring - 1
+	volatile uint8_t head;		// count of bytes written by the producer
+	volatile uint8_t tail;		// count of bytes read by the consumer
+} cRing;
+
+void ringReset(cRing *ring, uint8_t *data, uint8_t size) {
+	CRITICAL_SECTION_START;
+	ring->data = data;
+	ring->mask = size - 1;
+	ring->head = 0;
+	ring->tail = 0;
+	CRITICAL_SECTION_END;
+}
+
+static inline uint8_t ringCount(const cRing *ring) {
+	return (uint8_t)(ring->head - ring->tail);
+}
+
+static inline uint8_t ringSpace(const cRing *ring) {
+	return (ring->mask + 1) - (uint8_t)(ring->head - ring->tail);
+}
+
+static inline bool ringEmpty(const cRing *ring) {
+	return ring->head == ring->tail;
+}
+
+// producer: return the number of bytes which may be written in one piece at *span
+uint8_t ringWriteSpan(cRing *ring, uint8_t **span) {
+	uint8_t head = ring->head;
+	uint8_t offset = head & ring->mask;
+	uint8_t space = (ring->mask + 1) - (uint8_t)(head - ring->tail);
+	uint8_t contiguous = (ring->mask + 1) - offset;
+	*span = &(ring->data[offset]);
+	return (space < contiguous) ? space : contiguous;
+}
+
+// producer: add 'count' bytes written to the span
+static inline void ringWriteCommit(cRing *ring, uint8_t count) {
+	_RING_BARRIER();
+	ring->head += count;
+}
+
+// consumer: return the number of bytes which may be read in one piece at *span
+uint8_t ringReadSpan(cRing *ring, uint8_t **span) {
+	uint8_t tail = ring->tail;
+	uint8_t offset = tail & ring->mask;
+	uint8_t count = (uint8_t)(ring->head - tail);
+	uint8_t contiguous = (ring->mask + 1) - offset;
+	*span = &(ring->data[offset]);
+	_RING_BARRIER();
+	return (count < contiguous) ? count : contiguous;
+}
+
+// consumer: release 'count' bytes read from the span
+static inline void ringReadCommit(cRing *ring, uint8_t count) {
+	_RING_BARRIER();
+	ring->tail += count;
+}
+
+int ringPut(cRing *ring, uint8_t data) {
+	uint8_t head = ring->head;
+	if ((uint8_t)(head - ring->tail) > ring->mask)
+		return -1;
+	ring->data[head & ring->mask] = data;
+	_RING_BARRIER();
+	ring->head = head + 1;
+	return data;
+}
+
+int ringGet(cRing *ring) {
+	uint8_t tail = ring->tail;
+	if (tail == ring->head)
+		return -1;
+	_RING_BARRIER();
+	uint8_t data = ring->data[tail & ring->mask];
+	_RING_BARRIER();
+	ring->tail = tail + 1;
+	return data;
+}
+
+// producer: copy as much of 'data' as fits; returns the number of bytes written
+uint8_t ringWrite(cRing *ring, const uint8_t *data, uint8_t length) {
+	uint8_t written = 0;
+	uint8_t *span;
+	for (uint8_t i = 0; (i < 2) && (written < length); i++) {	// at most two pieces: to the end of the memory and from its start
+		uint8_t count = ringWriteSpan(ring, &span);
+		if (!count)
+			break;
+		if (count > (length - written))
+			count = length - written;
+		memcpy(span, &(data[written]), count);
+		ringWriteCommit(ring, count);
+		written += count;
+	}
+	return written;
+}
+
+// consumer: copy up to 'length' bytes out; returns the number of bytes read
+uint8_t ringRead(cRing *ring, uint8_t *data, uint8_t length) {
+	uint8_t read = 0;
+	uint8_t *span;
+	for (uint8_t i = 0; (i < 2) && (read < length); i++) {
+		uint8_t count = ringReadSpan(ring, &span);
+		if (!count)
+			break;
+		if (count > (length - read))
+			count = length - read;
+		memcpy(&(data[read]), span, count);
+		ringReadCommit(ring, count);
+		read += count;
+	}
+	return read;
+}
+
 #endif // __CIRCULAR_BUFFER_CODE // Circular Buffer Code
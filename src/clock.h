@@ -107,6 +107,30 @@ uint32_t clockMillis() {
 }
 
 
+/* ---
+#### uint32_t clockMicros()
+
+Return the time since `clockInit()` in microseconds as a 32bit unsigned integer. It wraps around after about 71 minutes,
+so only use it to measure short durations; eg: `elapsed = clockMicros() - start;`
+
+The resolution is 0.5us at 16Mhz (TIMER2 counts at 2Mhz).
+--- */
+
+uint32_t clockMicros() {
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t ms = _clock_ms;
+	uint8_t ticks = _clock_ticks;
+	uint8_t count = TCNT2;
+	// the counter may have just wrapped with its interrupt still pending
+	if ((TIFR2 & (1 << OCF2A)) && (count < (OCR2A / 2)))
+		ticks++;
+	SREG = sreg;
+
+	return (ms * 1000) + ((uint32_t)ticks * (1000000UL / TIMER_FREQ)) + (((uint32_t)count * (1000000UL / TIMER_FREQ)) / (OCR2A + 1));
+}
+
+
 /* ---
 #### void clockDelay(uint32_t duration)
 
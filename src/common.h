@@ -125,7 +125,7 @@ Parameters:
 Set the specified AVR pin to the mode.
 --- */
 
-void srxePinMode(uint8_t pincode, uint8_t mode) {
+void _srxe_pin_mode(uint8_t pincode, uint8_t mode) {
 	uint8_t bit;
 	volatile uint8_t *port, *ddr;
 
@@ -144,7 +144,7 @@ void srxePinMode(uint8_t pincode, uint8_t mode) {
 			*ddr |= (1 << bit);
 			break;
 	}
-} /* srxePinMode() */
+} /* _srxe_pin_mode() */
 
 
 /* ---
@@ -154,7 +154,7 @@ This is similar to the Arduino `digitalWrite()` but uses the pin code syntax.
 
 Use the available `#define` values of `HIGH` or `LOW`.
 --- */
-void srxeDigitalWrite(uint8_t pincode, uint8_t value) {
+void _srxe_digital_write(uint8_t pincode, uint8_t value) {
 	uint8_t bit;
 	volatile uint8_t *port, *ddr;
 
@@ -174,7 +174,7 @@ This is similar to the Arduino `digitalRead()` but uses the pin code syntax.
 
 Will return one of the `#define` values of `HIGH` or `LOW`.
 --- */
-uint8_t srxeDigitalRead(uint8_t pincode) {
+uint8_t _srxe_digital_read(uint8_t pincode) {
 	uint8_t bit;
 	volatile uint8_t *port, *ddr;
 
@@ -183,7 +183,65 @@ uint8_t srxeDigitalRead(uint8_t pincode) {
 		return HIGH;
 	else
 		return LOW;
-} /* srxeDigitalRead() */
+} /* _srxe_digital_read() */
+
+
+/* ---
+#### Constant Pin Codes
+
+`srxePinMode()`, `srxeDigitalWrite()`, and `srxeDigitalRead()` check if the pin code is known at compile time.
+When it is - as it is for the LCD, FLASH, and keyboard pins - the port register is resolved by the compiler and
+the call becomes a single `sbi`, `cbi`, or `sbis`/`sbic` instruction.
+Otherwise, the pin code is decoded at runtime with `srxePinMapper()`.
+
+**Note:** The compiler only resolves the pin code when optimization is enabled (which is always the case for AVR builds).
+--- */
+
+// these must produce the same registers as srxePinMapper()
+#define _SRXE_PIN_PORT(pc)	((((pc) & 0xf0) == SRXE_PORTB) ? &PORTB : (((pc) & 0xf0) == SRXE_PORTD) ? &PORTD : \
+							(((pc) & 0xf0) == SRXE_PORTE) ? &PORTE : (((pc) & 0xf0) == SRXE_PORTF) ? &PORTF : &PORTG)
+#define _SRXE_PIN_INPUT(pc)	((((pc) & 0xf0) == SRXE_PORTB) ? &PINB : (((pc) & 0xf0) == SRXE_PORTD) ? &PIND : \
+							(((pc) & 0xf0) == SRXE_PORTE) ? &PINE : (((pc) & 0xf0) == SRXE_PORTF) ? &PINF : &PING)
+#define _SRXE_PIN_DDR(pc)	((((pc) & 0xf0) == SRXE_PORTB) ? &DDRB : (((pc) & 0xf0) == SRXE_PORTD) ? &DDRD : \
+							(((pc) & 0xf0) == SRXE_PORTE) ? &DDRE : (((pc) & 0xf0) == SRXE_PORTF) ? &DDRF : &DDRG)
+#define _SRXE_PIN_BIT(pc)	(1 << ((pc) & 0x7))
+
+static inline __attribute__((always_inline)) void srxePinMode(uint8_t pincode, uint8_t mode) {
+	if (__builtin_constant_p(pincode) && __builtin_constant_p(mode)) {
+		switch (mode) {
+			case INPUT:
+				*_SRXE_PIN_DDR(pincode) &= ~_SRXE_PIN_BIT(pincode);
+				break;
+			case INPUT_PULLUP:
+				*_SRXE_PIN_DDR(pincode) |= _SRXE_PIN_BIT(pincode);
+				*_SRXE_PIN_PORT(pincode) |= _SRXE_PIN_BIT(pincode);
+				*_SRXE_PIN_DDR(pincode) &= ~_SRXE_PIN_BIT(pincode);
+				break;
+			case OUTPUT:
+				*_SRXE_PIN_DDR(pincode) |= _SRXE_PIN_BIT(pincode);
+				break;
+		}
+	} else {
+		_srxe_pin_mode(pincode, mode);
+	}
+}
+
+static inline __attribute__((always_inline)) void srxeDigitalWrite(uint8_t pincode, uint8_t value) {
+	if (__builtin_constant_p(pincode) && __builtin_constant_p(value)) {
+		if (value == LOW)
+			*_SRXE_PIN_PORT(pincode) &= ~_SRXE_PIN_BIT(pincode);
+		else
+			*_SRXE_PIN_PORT(pincode) |= _SRXE_PIN_BIT(pincode);
+	} else {
+		_srxe_digital_write(pincode, value);
+	}
+}
+
+static inline __attribute__((always_inline)) uint8_t srxeDigitalRead(uint8_t pincode) {
+	if (__builtin_constant_p(pincode))
+		return (*_SRXE_PIN_INPUT(pincode) & _SRXE_PIN_BIT(pincode)) ? HIGH : LOW;
+	return _srxe_digital_read(pincode);
+}
 
 /* ---
 #### long srxeMap(long val, long in_min, long in_max, long out_min, long out_max)
@@ -278,5 +336,21 @@ uint8_t _srxe_spi_transfer(volatile uint8_t data) {
 } /* _srxe_spi_transfer() */
 
 
+/*
+void _srxe_spi_claim() - end any transaction which a device has left open before selecting another device
+
+A device may leave its CS low between calls, eg: the FLASH while it streams data, and set _srxe_spi_release to end it.
+*/
+static void (*_srxe_spi_release)(void);
+
+static inline void _srxe_spi_claim() {
+	if (_srxe_spi_release) {
+		void (*release)(void) = _srxe_spi_release;
+		_srxe_spi_release = NULL;
+		release();
+	}
+} /* _srxe_spi_claim() */
+
+
 #endif // __SRXE_COMMON_
 
@@ -43,6 +43,7 @@ char _eeprom_sig[EEPROM_ID_SIZE+1];	// sotrage buffer for the computed signature
 // forward declarations to order the functions more logically
 uint8_t eepromReadByte(uint16_t addr);
 void eepromWriteByte(uint16_t addr, uint8_t data);
+static void _eeprom_id_init();
 
 /* ---
 #### void eepromInit()
@@ -50,6 +51,7 @@ void eepromWriteByte(uint16_t addr, uint8_t data);
 Initialization of the EEPROM functions.
 
 This function must be called prior to using any other EEPROM functions.
+It reads each of the IDs stored by `eepromAddID()`.
 --- */
 void eepromInit() {
 
@@ -70,6 +72,9 @@ void eepromInit() {
 	n = boot_signature_byte_get(0x0E + 3);
 	_eeprom_sig[5] = 'A' + (n % 26);
 	_eeprom_sig[6] = 0;
+
+	// the fingerprints of the stored IDs
+	_eeprom_id_init();
 }
 
 /* ---
@@ -148,63 +153,259 @@ char *eepromSignature() {
 	return _eeprom_sig;
 }
 
+// --------------------------------------------------------------------------------------------
+// the stored IDs
+//
+// The IDs are kept in an open addressing hash table of EEPROM_ID_SLOTS slots of EEPROM_ID_SIZE bytes; an empty slot starts with 0xFF.
+// RAM holds a one byte fingerprint of the ID in each slot, read once by eepromInit(), so most slots are passed over without
+// reading the EEPROM, along with the IDs found most recently. Only a slot whose fingerprint matches is read to be sure.
+//
+// Older code kept a count at EEPROM_ID_COUNT, followed by the IDs in the order they were stored; eepromInit() moves them into the table.
+
+#define EEPROM_ID_SLOTS				((EEPROM_MAX_ADDRESS - EEPROM_ID_STORAGE) / EEPROM_ID_SIZE)
+#define EEPROM_ID_HASHED			0xFE	// stored at EEPROM_ID_COUNT once the IDs are in the table; an older count was never more than EEPROM_ID_SLOTS
+#define EEPROM_ID_MIGRATING			0xFD	// stored at EEPROM_ID_COUNT while the older IDs are moved into the table
+#define EEPROM_ID_RECENT			4		// IDs found most recently, kept in RAM
+#define _EEPROM_ID_EMPTY			0xFF
+#define _EEPROM_ID_SLOT(n)			(EEPROM_ID_STORAGE + ((uint16_t)(n) * EEPROM_ID_SIZE))
+
+static uint8_t _eeprom_id_prints[EEPROM_ID_SLOTS];	// the fingerprint of the ID in each slot; 0 when the slot is empty
+static uint8_t _eeprom_id_count;
+static char _eeprom_id_recent[EEPROM_ID_RECENT][EEPROM_ID_SIZE];
+static uint8_t _eeprom_id_recent_next;
+
+// the slot an ID starts looking from, and its fingerprint
+static uint8_t _eeprom_id_hash(const char *code, uint8_t *print) {
+	uint16_t hash = 5381;
+	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
+		hash = (hash << 5) + hash + (uint8_t)code[i];
+	*print = (uint8_t)(hash >> 8) ^ (uint8_t)hash;
+	if (!*print)
+		*print = 1;
+	return hash % EEPROM_ID_SLOTS;
+}
+
+static bool _eeprom_id_match(uint8_t slot, const char *code) {
+	uint16_t addr = _EEPROM_ID_SLOT(slot);
+	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++) {
+		if ((uint8_t)code[i] != eepromReadByte(addr + i))
+			return false;
+	}
+	return true;
+}
+
+static bool _eeprom_id_recently(const char *code) {
+	for (uint8_t i = 0; i < EEPROM_ID_RECENT; i++) {
+		if (!memcmp(_eeprom_id_recent[i], code, EEPROM_ID_SIZE))
+			return true;
+	}
+	return false;
+}
+
+static void _eeprom_id_remember(const char *code) {
+	memcpy(_eeprom_id_recent[_eeprom_id_recent_next], code, EEPROM_ID_SIZE);
+	_eeprom_id_recent_next = (_eeprom_id_recent_next + 1) % EEPROM_ID_RECENT;
+}
+
+/*
+	return the slot holding the ID, or -1 with the first empty slot along the way in 'empty' (-1 when the table is full)
+	a fingerprint of 0 ends the search since IDs are never removed one at a time
+*/
+static int16_t _eeprom_id_find(const char *code, int16_t *empty) {
+	uint8_t print;
+	uint8_t slot = _eeprom_id_hash(code, &print);
+
+	*empty = -1;
+	for (uint8_t n = 0; n < EEPROM_ID_SLOTS; n++) {
+		if (!_eeprom_id_prints[slot]) {
+			*empty = slot;
+			return -1;
+		}
+		if ((_eeprom_id_prints[slot] == print) && _eeprom_id_match(slot, code))
+			return slot;
+		if (++slot >= EEPROM_ID_SLOTS)
+			slot = 0;
+	}
+	return -1;
+}
+
+// write an ID into an empty slot; the first byte goes last so a partly written ID is still an empty slot
+static void _eeprom_id_write(uint8_t slot, const char *code) {
+	uint16_t slot_start = _EEPROM_ID_SLOT(slot);
+	for (uint8_t i = EEPROM_ID_SIZE; i-- > 0; )
+		eepromWriteByte(slot_start + i, code[i]);
+}
+
+/*
+	move every ID to where a search finds it; it does not need to know how many IDs there are, so it may be run again
+	after the power fails part way. Each ID is written to its new slot before its old slot is emptied, so a power cut
+	leaves at worst a second copy, which the next run removes. Each move brings an ID closer to its first slot, so it ends.
+*/
+static void _eeprom_id_rehash() {
+	char code[EEPROM_ID_SIZE];
+	uint8_t print;
+	bool changed;
+
+	for (uint8_t slot = 0; slot < EEPROM_ID_SLOTS; slot++) {
+		_eeprom_id_prints[slot] = 0;
+		code[0] = eepromReadByte(_EEPROM_ID_SLOT(slot));
+		if ((uint8_t)code[0] == _EEPROM_ID_EMPTY)
+			continue;
+		for (uint8_t i = 1; i < EEPROM_ID_SIZE; i++)
+			code[i] = eepromReadByte(_EEPROM_ID_SLOT(slot) + i);
+		_eeprom_id_hash(code, &(_eeprom_id_prints[slot]));
+	}
+
+	do {
+		changed = false;
+		for (uint8_t from = 0; from < EEPROM_ID_SLOTS; from++) {
+			if (!_eeprom_id_prints[from])
+				continue;
+			for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
+				code[i] = eepromReadByte(_EEPROM_ID_SLOT(from) + i);
+
+			// follow the search for the ID until it reaches the ID, an empty slot, or an earlier copy of the ID
+			uint8_t slot = _eeprom_id_hash(code, &print);
+			while (slot != from) {
+				if (!_eeprom_id_prints[slot]) {
+					_eeprom_id_write(slot, code);
+					_eeprom_id_prints[slot] = print;
+					break;
+				}
+				if ((_eeprom_id_prints[slot] == print) && _eeprom_id_match(slot, code))
+					break;
+				if (++slot >= EEPROM_ID_SLOTS)
+					slot = 0;
+			}
+			if (slot != from) {
+				eepromWriteByte(_EEPROM_ID_SLOT(from), _EEPROM_ID_EMPTY);
+				_eeprom_id_prints[from] = 0;
+				changed = true;
+			}
+		}
+	} while (changed);
+}
+
+// read the fingerprints of the stored IDs, first moving any IDs stored by older code into the table
+static void _eeprom_id_init() {
+	uint8_t format = eepromReadByte(EEPROM_ID_COUNT);
+
+	if (format != EEPROM_ID_HASHED) {
+		if (format != EEPROM_ID_MIGRATING) {
+			// the slots past the older count do not hold IDs; 0xFF is an EEPROM which has never been written
+			uint8_t count = (format <= EEPROM_ID_SLOTS) ? format : 0;
+			for (uint8_t slot = count; slot < EEPROM_ID_SLOTS; slot++) {
+				if (eepromReadByte(_EEPROM_ID_SLOT(slot)) != _EEPROM_ID_EMPTY)
+					eepromWriteByte(_EEPROM_ID_SLOT(slot), _EEPROM_ID_EMPTY);
+			}
+			eepromWriteByte(EEPROM_ID_COUNT, EEPROM_ID_MIGRATING);
+		}
+		_eeprom_id_rehash();
+		eepromWriteByte(EEPROM_ID_COUNT, EEPROM_ID_HASHED);
+	}
+
+	_eeprom_id_count = 0;
+	for (uint8_t slot = 0; slot < EEPROM_ID_SLOTS; slot++) {
+		char code[EEPROM_ID_SIZE];
+		_eeprom_id_prints[slot] = 0;
+		code[0] = eepromReadByte(_EEPROM_ID_SLOT(slot));
+		if ((uint8_t)code[0] == _EEPROM_ID_EMPTY)
+			continue;
+		for (uint8_t i = 1; i < EEPROM_ID_SIZE; i++)
+			code[i] = eepromReadByte(_EEPROM_ID_SLOT(slot) + i);
+		_eeprom_id_hash(code, &(_eeprom_id_prints[slot]));
+		_eeprom_id_count++;
+	}
+	memset(_eeprom_id_recent, _EEPROM_ID_EMPTY, sizeof(_eeprom_id_recent));
+}
+
+
+/* ---
+#### bool eepromHasID(const char \*code)
+
+Returns `true` if the 6 character `code` has been stored by `eepromAddID()`.
+
+Most codes are found in RAM: a code which was not stored usually needs no EEPROM reads,
+a recently found code needs none, and any other stored code needs only its own 6 bytes read.
+--- */
+
+bool eepromHasID(const char *code) {
+	int16_t empty;
+
+	if (code == NULL)
+		return false;
+	if (_eeprom_id_recently(code))
+		return true;
+	if (_eeprom_id_find(code, &empty) < 0)
+		return false;
+	_eeprom_id_remember(code);
+	return true;
+}
+
 /* ---
 #### int eepromAddID(char \*new_code)
 
 Store a 6 character code, checking if the `new_code` has previously been stored.
 
+Returns the number of codes stored, or -1 if the code is this device's own, was already stored, or there is no room;
+there is room for `EEPROM_ID_SLOTS` (170) codes. The first byte of a code must not be 0xFF.
+
 _Useful for tracking interations with other similar devices such as RF traffic._
 
 --- */
 
 int eepromAddID (char *new_code) {
+	int16_t empty;
+
 	if (new_code == NULL)
 		return -1;
 
-	// we need to check if we have already received this ID
-	uint8_t count = eepromReadByte(EEPROM_ID_COUNT);
-	uint16_t slot_start;
-	uint8_t matched = false;
-
-	matched = true;
-
 	// test for our own ID
-	char* sig = eepromSignature();
-	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
-		if (new_code[i] != sig[i])
-			matched = false;						// the current test is not a match
+	if (!memcmp(new_code, eepromSignature(), EEPROM_ID_SIZE))
+		return -1;
 
-	if (matched)									// we found ourself ?!
+	if (_eeprom_id_recently(new_code))
+		return -1;
+	if (_eeprom_id_find(new_code, &empty) >= 0) {
+		_eeprom_id_remember(new_code);
+		return -1;
+	}
+	if ((empty < 0) || ((uint8_t)new_code[0] == _EEPROM_ID_EMPTY))
 		return -1;
 
-	// test all of the IDs we have already stored
-	for (uint8_t slot_num = 0; slot_num < count; slot_num++) {
-		slot_start = EEPROM_ID_STORAGE + (slot_num * EEPROM_ID_SIZE);
+	// we never found a match so store the new ID
+	_eeprom_id_write(empty, new_code);
+	_eeprom_id_hash(new_code, &(_eeprom_id_prints[empty]));
+	_eeprom_id_remember(new_code);
+	_eeprom_id_count++;
 
-		// while unlikely, we want to avoid running off the end of the eeprom space
-		if ((slot_start + EEPROM_ID_SIZE) >= EEPROM_MAX_ADDRESS)
-			return -1;
+	return _eeprom_id_count;
+}
 
-		matched = true; // assume we will find a match
-		for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
-			if (new_code[i] != eepromReadByte(slot_start+i))
-				matched = false;						// the current slot is not a match
-		if (matched)									// no need to continue if we found a match
-			break;
-		matched = false;								// we assume not a match in case the for loop is done
-	}
+/* ---
+#### uint8_t eepromCountID()
 
-	if (matched)
-		return -1;
+Returns the number of codes stored by `eepromAddID()`.
+--- */
 
-	// we never found a match so store the new ID
-	slot_start = EEPROM_ID_STORAGE + (count * EEPROM_ID_SIZE);
-	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
-		eepromWriteByte(slot_start+i, new_code[i]);
-	count++;
-	eepromWriteByte(EEPROM_ID_COUNT, count);
+uint8_t eepromCountID() {
+	return _eeprom_id_count;
+}
+
+/* ---
+#### void eepromClearIDs()
+
+Forget all of the codes stored by `eepromAddID()`.
+--- */
 
-	return count;
+void eepromClearIDs() {
+	for (uint8_t slot = 0; slot < EEPROM_ID_SLOTS; slot++) {
+		if (_eeprom_id_prints[slot])
+			eepromWriteByte(_EEPROM_ID_SLOT(slot), _EEPROM_ID_EMPTY);
+		_eeprom_id_prints[slot] = 0;
+	}
+	_eeprom_id_count = 0;
+	memset(_eeprom_id_recent, _EEPROM_ID_EMPTY, sizeof(_eeprom_id_recent));
 }
 
 #endif // __EEPROM_
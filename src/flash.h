@@ -22,7 +22,16 @@ A page must be in an erased state prior to a write operation.
 Pages are stored in sectors.
 A sector is 4KB and must be erased as a complete unit.
 Thus, to re-write a 256 page, it's entire sector must be erased.
-Any page/sector management is left as a tedious exercise for the developer.
+Any page/sector management is left as a tedious exercise for the developer, or see `flashlog.h`.
+
+The sizes are:
+```C
+*/
+#define FLASH_SIZE			131072L
+#define FLASH_SECTOR_SIZE	4096
+#define FLASH_PAGE_SIZE		256
+/*
+```
 
 --------------------------------------------------------------------------
 --- */
@@ -50,12 +59,91 @@ Initialization of the FLASH chip functions.
 This function must be called prior to using any other FLASH functions.
 --- */
 void flashInit() {
+	_srxe_spi_claim();
 	_srxe_spi_init();
 	srxePinMode(FLASH_CS, OUTPUT); // in case we want to use the SPI flash
 	srxeDigitalWrite(FLASH_CS, HIGH); // in case we want to use the SPI flash
 }
 
 
+static bool _flash_pending;	// an erase or write was started and has not been seen to finish
+static uint32_t _flash_changes;	// counts the erases and writes, so copies of the data know when they may be out of date
+
+static uint8_t _flash_status() {
+	_srxe_spi_claim();
+	srxeDigitalWrite(FLASH_CS, LOW);
+	_srxe_spi_transfer(0x05); // read status register
+	uint8_t rc = _srxe_spi_transfer(0);
+	srxeDigitalWrite(FLASH_CS, HIGH);
+	if (!(rc & 1))
+		_flash_pending = false;
+	return rc;
+}
+
+// send a command with a 3-uint8_t address (big-endian order); CS is left low so data may follow
+static void _flash_command(uint8_t command, uint32_t addr) {
+	_srxe_spi_claim();
+	srxeDigitalWrite(FLASH_CS, LOW);
+	_srxe_spi_transfer(command);
+	_srxe_spi_transfer((uint8_t)(addr >> 16));	// AD1
+	_srxe_spi_transfer((uint8_t)(addr >> 8));	// AD2
+	_srxe_spi_transfer((uint8_t)addr);			// AD3
+}
+
+// the erase and write commands must each follow a write enable
+static bool _flash_write_enable(bool unprotect) {
+	if (_flash_status() & 1) // the chip is busy in a write operation
+		return false;
+
+	if (unprotect) {
+		// Disable write protect by clearing the status bits
+		srxeDigitalWrite(FLASH_CS, LOW);
+		_srxe_spi_transfer(0x01); // WRSR - write status register
+		_srxe_spi_transfer(0x00); // set all bits to 0
+		srxeDigitalWrite(FLASH_CS, HIGH);
+	}
+
+	srxeDigitalWrite(FLASH_CS, LOW);
+	_srxe_spi_transfer(0x06); // WREN - Write enable
+	srxeDigitalWrite(FLASH_CS, HIGH);
+	return true;
+}
+
+// start erasing a sector; it takes about 60ms
+static bool _flash_erase_start(uint32_t addr) {
+	if (!_flash_write_enable(false))
+		return false;
+	_flash_command(0x20, addr); // Sector Erase
+	srxeDigitalWrite(FLASH_CS, HIGH); // this executes the command internally
+	_flash_pending = true;
+	_flash_changes++;
+	return true;
+}
+
+// start writing data within a page; it takes up to 3ms
+static bool _flash_write_start(uint32_t addr, const uint8_t *data, uint16_t count) {
+	if (!_flash_write_enable(true))
+		return false;
+	_flash_command(0x02, addr); // PP - page program
+	for (uint16_t i = 0; i < count; i++)
+		_srxe_spi_transfer(data[i]); // write the data uint8_ts
+	srxeDigitalWrite(FLASH_CS, HIGH); // this executes the command internally
+	_flash_pending = true;
+	_flash_changes++;
+	return true;
+}
+
+// wait for an erase or write to complete
+static bool _flash_wait(uint8_t timeout) {
+	while (_flash_status() & 1) {
+		_delay_ms(1);
+		if (!timeout--) // took too long, bail out
+			return false;
+	}
+	return true;
+}
+
+
 /* ---
 #### int flashEraseSector(uint32_t addr, bool wait)
 
@@ -71,126 +159,82 @@ bool flashEraseSector(uint32_t addr, int wait) {
 	if (addr & 4095L) // invalid address
 		return false;
 
-	uint8_t rc;
-	int timeout;
-
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x05); // read status register
-	rc = _srxe_spi_transfer(0);
-	srxeDigitalWrite(FLASH_CS, HIGH);
-
-	if (rc & 1) // indicates the chip is busy in a write operation
-		return false; // fail
-
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x06); // WREN - Write enable
-	srxeDigitalWrite(FLASH_CS, HIGH);
-
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x20); // Sector Erase
-	// send 3-uint8_t address (big-endian order)
-	_srxe_spi_transfer((uint8_t)(addr >> 16));	// AD1
-	_srxe_spi_transfer((uint8_t)(addr >> 8));	// AD2
-	_srxe_spi_transfer((uint8_t)addr);		 	// AD3
-	srxeDigitalWrite(FLASH_CS, HIGH);
+	if (!_flash_erase_start(addr))
+		return false; // the chip is busy in a write operation
 
 	// wait for the erase to complete
-	if (wait) {
-		rc = 1;
-		timeout = 0;
-		while (rc & 1) {
-			srxeDigitalWrite(FLASH_CS, LOW);
-			_srxe_spi_transfer(0x05); // read status register
-			rc = _srxe_spi_transfer(0);
-			srxeDigitalWrite(FLASH_CS, HIGH);
-			_delay_ms(1);
-			timeout++;
-			if (timeout >= 100) { // took too long, bail out
-				return false;
-			}
-		}
-	} // if asked to wait
+	if (wait)
+		return _flash_wait(100);
 	return true;
 } /* SRXEFlashEraseSector() */
 
 
 /* ---
-#### int flashWritePage(uint32_t addr, uint8_t* data)
+#### bool flashBusy()
 
-Write a page (up to 256 bytes) of data.
+Returns `true` while the FLASH chip is still erasing or writing.
+--- */
+bool flashBusy() {
+	return (_flash_status() & 1);
+}
+
+
+/* ---
+#### bool flashWrite(uint32_t addr, const uint8_t* data, uint16_t count)
+
+Write `count` bytes of data within one page; the data must not cross a page boundary.
+
+Only the bytes written are changed, so a page may be filled a little at a time.
+The bytes must be in an erased state.
 
 Returns `false` if the operation failed.
 
 **Note:** It will wait no more than 25ms.
 --- */
-bool flashWritePage(uint32_t addr, uint8_t *data) {
-	if (addr & 255L) // invalid address
+bool flashWrite(uint32_t addr, const uint8_t *data, uint16_t count) {
+	if (!count || (((addr & 255L) + count) > FLASH_PAGE_SIZE)) // crosses a page
 		return false;
 
-	int i, timeout;
-	uint8_t rc;
+	if (!_flash_write_start(addr, data, count))
+		return false; // the chip is busy in a write operation
 
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x05); // read status register
-	rc = _srxe_spi_transfer(0);
-	srxeDigitalWrite(FLASH_CS, HIGH);
-	if (rc & 1) // indicates the chip is busy in a write operation
-		return false; // fail
+	// wait for the write to complete
+	return _flash_wait(25);
+}
 
-	// Disable write protect by clearing the status bits
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x01); // WRSR - write status register
-	_srxe_spi_transfer(0x00); // set all bits to 0
-	srxeDigitalWrite(FLASH_CS, HIGH);
 
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x06); // WREN - Write enable
-	srxeDigitalWrite(FLASH_CS, HIGH);
+/* ---
+#### int flashWritePage(uint32_t addr, uint8_t* data)
 
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x02); // PP - page program
-	// send 3-uint8_t address (big-endian order)
-	_srxe_spi_transfer((uint8_t)(addr >> 16)); // AD1
-	_srxe_spi_transfer((uint8_t)(addr >> 8));	 // AD2
-	_srxe_spi_transfer((uint8_t)addr);		 // AD3
-	for (i = 0; i < 256; i++)
-		_srxe_spi_transfer(data[i]); // write the 256 data uint8_ts
+Write a page (up to 256 bytes) of data.
 
-	srxeDigitalWrite(FLASH_CS, HIGH); // this executes the command internally
-	// wait for the write to complete
-	rc = 1;
-	timeout = 0;
+Returns `false` if the operation failed.
 
-	while (rc & 1) {
-		srxeDigitalWrite(FLASH_CS, LOW);
-		_srxe_spi_transfer(0x05); // read status register
-		rc = _srxe_spi_transfer(0);
-		srxeDigitalWrite(FLASH_CS, HIGH);
-		_delay_ms(1);
-		timeout++;
-		if (timeout >= 25) { // took too long, bail out
-			return false;
-		}
-	}
-	return true;
+**Note:** It will wait no more than 25ms.
+--- */
+bool flashWritePage(uint32_t addr, uint8_t *data) {
+	if (addr & 255L) // invalid address
+		return false;
+
+	return flashWrite(addr, data, FLASH_PAGE_SIZE);
 }
 
 
 /* ---
-#### int flashWritePage(uint32_t addr, uint8_t* buffer, uint16_t count)
+#### bool SRXEFlashRead(uint32_t addr, uint8_t* buffer, uint16_t count)
 
 Read `count` bytes of data from FLASH.
+
+Returns `false`, and reads nothing, while the chip is still erasing or writing; the chip can not be read until it finishes.
 --- */
 
 bool SRXEFlashRead(uint32_t addr, uint8_t *buffer, uint16_t count) {
 	int i;
 
-	srxeDigitalWrite(FLASH_CS, LOW);
-	_srxe_spi_transfer(0x03); // issue read instruction
-	// send 3-uint8_t address (big-endian order)
-	_srxe_spi_transfer((uint8_t)(addr >> 16)); // AD1
-	_srxe_spi_transfer((uint8_t)(addr >> 8));	 // AD2
-	_srxe_spi_transfer((uint8_t)addr);		 // AD3
+	if (_flash_pending && (_flash_status() & 1))
+		return false;
+
+	_flash_command(0x03, addr); // issue read instruction
 	for (i = 0; i < count; i++)					 // read the uint8_ts out
 		*buffer++ = _srxe_spi_transfer(0); // need to write something to read from SPI
 
@@ -0,0 +1,228 @@
+/* ************************************************************************************
+* File:    flashjob.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### FLASH Jobs
+**Erase and Write the FLASH Chip without Waiting**
+
+Erasing a sector of the FLASH chip takes about 60ms, and writing a page up to 3ms. `flashEraseSector()` and `flashWritePage()`
+wait for them to finish, and nothing else happens while they wait; the keyboard is not scanned and received frames are not handled.
+
+FLASH jobs start the erase or write and return at once. `flashJobPoll()`, called each time through the main loop,
+checks on the job with a single read of the status of the chip, calls the job's function when it finishes, and starts the next job.
+The SPI bus is only used for a moment each time, so the LCD may be drawn while the chip erases.
+
+**Note:** The chip can not be read while it erases or writes; see `SRXEFlashRead()`.
+`flashJobPoll()` uses the SPI bus, which is shared with the LCD, so it must not be called from an interrupt.
+
+The jobs are set at compile time:
+```C
+*/
+#ifndef FLASH_JOBS
+#define FLASH_JOBS			4		// jobs which may wait to start
+#endif
+#ifndef FLASH_JOB_TRACE
+#define FLASH_JOB_TRACE		0		// when 1, flashJobTrace() reports the time the main loop took between calls to flashJobPoll()
+#endif
+/*
+```
+
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_FLASHJOB_
+#define __SRXE_FLASHJOB_
+
+#include "common.h"
+#include "clock.h"
+#include "flash.h"
+
+/* ---
+A job calls a `FLASHJOBDONE` function when it finishes, with the address of the job and whether it succeeded:
+```C
+*/
+typedef void (*FLASHJOBDONE)(uint32_t addr, bool ok);
+/*
+```
+--- */
+
+#define _FLASH_JOB_ERASE		1
+#define _FLASH_JOB_WRITE		2
+
+#define _FLASH_JOB_ERASE_TIMEOUT	150		// milliseconds; the chip takes no more than 120ms
+#define _FLASH_JOB_WRITE_TIMEOUT	25
+
+typedef struct _FLASHJOB {
+	uint8_t type;
+	uint32_t addr;
+	const uint8_t *data;	// the data to write; it must not change until the job starts
+	uint16_t count;
+	FLASHJOBDONE done;
+} FLASHJOB;
+
+static FLASHJOB _flash_jobs[FLASH_JOBS];
+static uint8_t _flash_job_first;	// the job which is running, or is next to start
+static uint8_t _flash_job_count;
+static bool _flash_job_running;
+static uint32_t _flash_job_started;
+
+#if FLASH_JOB_TRACE
+static uint32_t _flash_job_trace_last;		// clockMicros() at the last call to flashJobPoll()
+static uint32_t _flash_job_trace_longest;
+static uint32_t _flash_job_trace_polls;
+#endif
+
+static bool _flash_job_add(uint8_t type, uint32_t addr, const uint8_t *data, uint16_t count, FLASHJOBDONE done) {
+	if (_flash_job_count >= FLASH_JOBS)
+		return false;
+	FLASHJOB *job = &(_flash_jobs[(_flash_job_first + _flash_job_count) % FLASH_JOBS]);
+	job->type = type;
+	job->addr = addr;
+	job->data = data;
+	job->count = count;
+	job->done = done;
+	_flash_job_count++;
+	return true;
+}
+
+// the first job is finished; the next job may start
+static void _flash_job_finish(bool ok) {
+	FLASHJOB *job = &(_flash_jobs[_flash_job_first]);
+	_flash_job_running = false;
+	_flash_job_first = (_flash_job_first + 1) % FLASH_JOBS;
+	_flash_job_count--;
+	if (job->done)
+		job->done(job->addr, ok);
+}
+
+
+/* ---
+#### bool flashJobErase(uint32_t addr, FLASHJOBDONE done)
+
+Add a job to erase the 4KB sector at `addr`. The `done` function, which may be NULL, is called from `flashJobPoll()` when it finishes.
+
+Returns `false` if the address is not the start of a sector or there are already `FLASH_JOBS` jobs waiting.
+--- */
+
+bool flashJobErase(uint32_t addr, FLASHJOBDONE done) {
+	if ((addr & (FLASH_SECTOR_SIZE - 1)) || (addr >= FLASH_SIZE))
+		return false;
+	return _flash_job_add(_FLASH_JOB_ERASE, addr, NULL, 0, done);
+}
+
+/* ---
+#### bool flashJobWrite(uint32_t addr, const uint8_t *data, uint16_t count, FLASHJOBDONE done)
+
+Add a job to write `count` bytes within one page, as `flashWrite()` does. The `done` function, which may be NULL,
+is called from `flashJobPoll()` when it finishes.
+
+The data is not copied. It must not change until the job starts; it is safe to change once `done` is called.
+
+Returns `false` if the data crosses a page or there are already `FLASH_JOBS` jobs waiting.
+--- */
+
+bool flashJobWrite(uint32_t addr, const uint8_t *data, uint16_t count, FLASHJOBDONE done) {
+	if (!count || (((addr & (FLASH_PAGE_SIZE - 1)) + count) > FLASH_PAGE_SIZE) || (addr >= FLASH_SIZE))
+		return false;
+	return _flash_job_add(_FLASH_JOB_WRITE, addr, data, count, done);
+}
+
+/* ---
+#### void flashJobPoll()
+
+Check on the running job and start the next one. Call it each time through the main loop.
+It takes one read of the status of the chip when a job is running, and does nothing when there are no jobs.
+--- */
+
+void flashJobPoll() {
+#if FLASH_JOB_TRACE
+	uint32_t now = clockMicros();
+	if (_flash_job_trace_polls++ && ((now - _flash_job_trace_last) > _flash_job_trace_longest))
+		_flash_job_trace_longest = now - _flash_job_trace_last;
+	_flash_job_trace_last = now;
+#endif
+
+	if (!_flash_job_count)
+		return;
+
+	FLASHJOB *job = &(_flash_jobs[_flash_job_first]);
+	if (_flash_job_running) {
+		if (!flashBusy()) {
+			_flash_job_finish(true);
+		} else if ((clockMillis() - _flash_job_started) > ((job->type == _FLASH_JOB_ERASE) ? _FLASH_JOB_ERASE_TIMEOUT : _FLASH_JOB_WRITE_TIMEOUT)) {
+			_flash_job_finish(false);
+		}
+		if (!_flash_job_count)
+			return;
+		job = &(_flash_jobs[_flash_job_first]);
+	}
+
+	// the chip may still be busy with an erase or write which was not a job
+	if (!_flash_job_running) {
+		if (job->type == _FLASH_JOB_ERASE)
+			_flash_job_running = _flash_erase_start(job->addr);
+		else
+			_flash_job_running = _flash_write_start(job->addr, job->data, job->count);
+		_flash_job_started = clockMillis();
+	}
+}
+
+/* ---
+#### uint8_t flashJobsPending()
+
+Return the number of jobs which are running or waiting to start.
+--- */
+
+uint8_t flashJobsPending() {
+	return _flash_job_count;
+}
+
+/* ---
+#### bool flashJobFinish()
+
+Wait for all of the jobs to finish; use it only when there is nothing else to do, eg: before turning the SRXE off.
+
+Returns `false` if a job failed to finish in time.
+--- */
+
+bool flashJobFinish() {
+	while (_flash_job_count) {
+		uint8_t count = _flash_job_count;
+		uint32_t started = clockMillis();
+		while (_flash_job_count == count) {
+			flashJobPoll();
+			if ((clockMillis() - started) > (_FLASH_JOB_ERASE_TIMEOUT * 2))
+				return false;
+		}
+	}
+	return true;
+}
+
+#if FLASH_JOB_TRACE
+/* ---
+#### uint32_t flashJobTrace(bool reset)
+
+Return the longest time, in microseconds, between two calls to `flashJobPoll()`, and start over when `reset` is true.
+This is how long the main loop stalls; eg: run a sector erase and check the main loop kept turning while the chip was busy.
+
+**Note:** This is only included when `FLASH_JOB_TRACE` is 1.
+--- */
+
+uint32_t flashJobTrace(bool reset) {
+	uint32_t longest = _flash_job_trace_longest;
+	if (reset) {
+		_flash_job_trace_longest = 0;
+		_flash_job_trace_polls = 0;
+	}
+	return longest;
+}
+#endif
+
+#endif // __SRXE_FLASHJOB_
@@ -0,0 +1,565 @@
+/* ************************************************************************************
+* File:    flashlog.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### FLASH Log
+**An Append-Only Store of Records on the FLASH Chip**
+
+The FLASH log keeps records, eg: the lines of a chat, on the FLASH chip so they survive turning the SRXE off.
+Records are only ever added after the newest record, so adding one never has to read, erase,
+and rewrite a whole 4KB sector; it is a single write of just the bytes of the record. Each record carries a CRC.
+
+The sectors are used in turn as a ring. Each sector starts with a small header holding its place in the log.
+The number of records in each sector is kept in RAM, so the newest records are found without reading the whole log.
+When only the spare sector is left, the oldest sector is erased by `flashLogPoll()` while the program does other work,
+and its records are lost. Since the sectors are used in turn, they all wear evenly.
+
+A record which is damaged when the power fails while it is being written is skipped when the log is read;
+the records written before it are never changed.
+
+The log is set at compile time:
+```C
+*/
+#ifndef FLASH_LOG_FIRST
+#define FLASH_LOG_FIRST		0		// the first sector of the log; sectors before it are left for other uses
+#endif
+#ifndef FLASH_LOG_SECTORS
+#define FLASH_LOG_SECTORS	32		// sectors used by the log; 3 .. 32 and no more than 32 - FLASH_LOG_FIRST
+#endif
+#ifndef FLASH_LOG_BUFFERS
+#define FLASH_LOG_BUFFERS	2		// records which may wait to be written while a sector is erased; each takes 256 bytes of RAM
+#endif								// FLASH_JOBS must be at least one more than FLASH_LOG_BUFFERS
+/*
+```
+
+Records are 1 .. `FLASH_LOG_RECORD_MAX` (245) bytes.
+
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_FLASHLOG_
+#define __SRXE_FLASHLOG_
+
+#include "common.h"
+#include "flash.h"
+#include "flashjob.h"
+
+#define FLASH_LOG_RECORD_HEADER	3	// length (1), CRC (2)
+#define FLASH_LOG_RECORD_MAX	(FLASH_PAGE_SIZE - _FLASH_LOG_HEADER - FLASH_LOG_RECORD_HEADER)	// the first record of a sector shares its page with the sector header
+
+#define _FLASH_LOG_HEADER		8	// magic (2), sequence (2), erase count (2), CRC (2)
+#define _FLASH_LOG_MAGIC		0x4C53
+#define _FLASH_LOG_EMPTY		0xFF
+
+// the state of each sector
+#define _FLASH_LOG_DIRTY		0	// must be erased before it is used
+#define _FLASH_LOG_ERASING		1
+#define _FLASH_LOG_FREE			2	// erased
+#define _FLASH_LOG_USED			3	// part of the log
+
+static uint8_t _flash_log_state[FLASH_LOG_SECTORS];
+static uint16_t _flash_log_sequence[FLASH_LOG_SECTORS];	// the order of the sectors in the log
+static uint16_t _flash_log_records[FLASH_LOG_SECTORS];
+static uint16_t _flash_log_erases[FLASH_LOG_SECTORS];
+
+static bool _flash_log_inited;
+static uint8_t _flash_log_head;		// the sector with the newest records
+static uint8_t _flash_log_tail;		// the sector with the oldest records
+static uint8_t _flash_log_used;		// sectors in the log; 0 when it is empty
+static uint32_t _flash_log_write;	// where the next record goes
+static uint16_t _flash_log_damaged;
+
+// records waiting to be written by a FLASH job, and the sector each is in; they are written in turn
+static uint8_t _flash_log_buffers[FLASH_LOG_BUFFERS][FLASH_PAGE_SIZE];
+static uint8_t _flash_log_buffer_sector[FLASH_LOG_BUFFERS];
+static uint8_t _flash_log_buffer_first;
+static uint8_t _flash_log_buffered;
+
+#define _FLASH_LOG_NEXT(s)		(((s) + 1) % FLASH_LOG_SECTORS)
+#define _FLASH_LOG_PREV(s)		(((s) + FLASH_LOG_SECTORS - 1) % FLASH_LOG_SECTORS)
+#define _FLASH_LOG_ADDRESS(s)	((uint32_t)((s) + FLASH_LOG_FIRST) * FLASH_SECTOR_SIZE)
+
+static uint16_t _flash_log_crc(uint16_t crc, const uint8_t *data, uint8_t length) {
+	for (uint8_t i = 0; i < length; i++)
+		crc = _crc_ccitt_update(crc, data[i]);
+	return crc;
+}
+
+/*
+	step through the records of a sector, from the first, until 'skip' records have been passed or the records end
+	returns the address of the next record, or of where the next record would go; 'count' is the records passed
+
+	records do not cross pages; a page ends at its first empty byte, or at a length which cannot be right
+	because the power failed while it was being written; the records end at the first page which starts empty
+*/
+static uint32_t _flash_log_walk(uint8_t sector, uint16_t skip, uint16_t *count) {
+	uint32_t address = _FLASH_LOG_ADDRESS(sector) + _FLASH_LOG_HEADER;
+	uint32_t end = _FLASH_LOG_ADDRESS(sector) + FLASH_SECTOR_SIZE;
+	uint32_t open = address;
+	uint8_t length;
+
+	*count = 0;
+	while ((address < end) && (*count < skip)) {
+		uint32_t page_end = (address | (FLASH_PAGE_SIZE - 1)) + 1;
+		bool page_start = !(address & (FLASH_PAGE_SIZE - 1)) || (address == (_FLASH_LOG_ADDRESS(sector) + _FLASH_LOG_HEADER));
+
+		if ((page_end - address) <= FLASH_LOG_RECORD_HEADER) {
+			address = page_end;
+			continue;
+		}
+		SRXEFlashRead(address, &length, 1);
+		if (length == _FLASH_LOG_EMPTY) {
+			if (page_start)
+				return open;	// nothing has been written past here
+			open = address;
+			address = page_end;
+			continue;
+		}
+		if (!length || (length > (page_end - address - FLASH_LOG_RECORD_HEADER))) {
+			address = open = page_end;
+			continue;
+		}
+		address += FLASH_LOG_RECORD_HEADER + length;
+		open = address;
+		(*count)++;
+	}
+	return (address < end) ? address : end;
+}
+
+// move on from where a record might be to where it is, past the free end of a page and anything which is not a record
+static uint32_t _flash_log_find(uint32_t address, uint32_t end, uint8_t *length) {
+	while (address < end) {
+		uint32_t page_end = (address | (FLASH_PAGE_SIZE - 1)) + 1;
+		if ((page_end - address) > FLASH_LOG_RECORD_HEADER) {
+			SRXEFlashRead(address, length, 1);
+			if ((*length != _FLASH_LOG_EMPTY) && *length && (*length <= (page_end - address - FLASH_LOG_RECORD_HEADER)))
+				return address;
+		}
+		address = page_end;
+	}
+	return end;
+}
+
+// true if the CRC of the record matches its data
+static bool _flash_log_intact(uint32_t address, uint8_t length) {
+	uint8_t buffer[16];
+	uint16_t crc = _crc_ccitt_update(0xFFFF, length);
+	uint16_t stored;
+
+	SRXEFlashRead(address + 1, (uint8_t *)&stored, 2);
+	address += FLASH_LOG_RECORD_HEADER;
+	while (length) {
+		uint8_t count = (length < sizeof(buffer)) ? length : sizeof(buffer);
+		SRXEFlashRead(address, buffer, count);
+		crc = _flash_log_crc(crc, buffer, count);
+		address += count;
+		length -= count;
+	}
+	return (crc == stored);
+}
+
+// true if the bytes are all erased
+static bool _flash_log_blank(uint32_t address, uint16_t length) {
+	uint8_t buffer[16];
+	while (length) {
+		uint8_t count = (length < sizeof(buffer)) ? length : sizeof(buffer);
+		SRXEFlashRead(address, buffer, count);
+		for (uint8_t i = 0; i < count; i++) {
+			if (buffer[i] != _FLASH_LOG_EMPTY)
+				return false;
+		}
+		address += count;
+		length -= count;
+	}
+	return true;
+}
+
+// wait for an erase to finish; it takes about 60ms and no more than 120ms
+static bool _flash_log_wait() {
+	for (uint8_t i = 0; (i < 150) && flashBusy(); i++)
+		_delay_ms(1);
+	return !flashBusy();
+}
+
+// the oldest sector leaves the log so it may be erased
+static void _flash_log_drop_tail() {
+	_flash_log_state[_flash_log_tail] = _FLASH_LOG_DIRTY;
+	_flash_log_records[_flash_log_tail] = 0;
+	_flash_log_tail = _FLASH_LOG_NEXT(_flash_log_tail);
+	_flash_log_used--;
+}
+
+// called from flashJobPoll() when the erase of a sector finishes
+static void _flash_log_erased(uint32_t addr, bool ok) {
+	uint8_t sector = (addr / FLASH_SECTOR_SIZE) - FLASH_LOG_FIRST;
+	// the log may already have moved on to the sector; its records follow the erase
+	if (_flash_log_state[sector] == _FLASH_LOG_ERASING)
+		_flash_log_state[sector] = ok ? _FLASH_LOG_FREE : _FLASH_LOG_DIRTY;
+}
+
+// called from flashJobPoll() when the write of a record finishes
+static void _flash_log_written(uint32_t addr, bool ok) {
+	uint8_t sector = _flash_log_buffer_sector[_flash_log_buffer_first];
+	_flash_log_buffer_first = (_flash_log_buffer_first + 1) % FLASH_LOG_BUFFERS;
+	_flash_log_buffered--;
+	if (ok) {
+		_flash_log_records[sector]++;
+	} else if (!_flash_log_buffered) {
+		// whatever was written is skipped when the log is read
+		_flash_log_write = (addr | (FLASH_PAGE_SIZE - 1)) + 1;
+	}
+}
+
+// start erasing a sector, if it needs it; true once it is erased
+static bool _flash_log_erase(uint8_t sector) {
+	if ((_flash_log_state[sector] == _FLASH_LOG_DIRTY) && flashJobErase(_FLASH_LOG_ADDRESS(sector), _flash_log_erased)) {
+		_flash_log_erases[sector]++;
+		_flash_log_state[sector] = _FLASH_LOG_ERASING;
+	}
+	return (_flash_log_state[sector] == _FLASH_LOG_FREE);
+}
+
+// run the jobs until there is a buffer and a job for another record; only when records are added faster than they can be written
+static bool _flash_log_ready(uint8_t jobs) {
+	uint32_t started = clockMillis();
+	while ((_flash_log_buffered >= FLASH_LOG_BUFFERS) || ((flashJobsPending() + jobs) > FLASH_JOBS)) {
+		flashJobPoll();
+		if ((clockMillis() - started) > 250)
+			return false;
+	}
+	return true;
+}
+
+
+/* ---
+#### bool flashLogInit()
+
+Find the log on the FLASH chip, or start a new one if there is none. Call it once, after `flashInit()`.
+It reads the header of each sector and steps through the records to count them.
+
+Returns `false` if the FLASH chip does not respond.
+--- */
+
+bool flashLogInit() {
+	uint8_t header[_FLASH_LOG_HEADER];
+	int8_t newest = -1;
+
+	_flash_log_inited = false;
+	_flash_log_buffered = 0;
+	if (!flashJobFinish() || !_flash_log_wait())
+		return false;
+
+	for (uint8_t s = 0; s < FLASH_LOG_SECTORS; s++) {
+		SRXEFlashRead(_FLASH_LOG_ADDRESS(s), header, _FLASH_LOG_HEADER);
+		_flash_log_records[s] = 0;
+		_flash_log_state[s] = _FLASH_LOG_DIRTY;
+		if (((header[0] | (header[1] << 8)) != _FLASH_LOG_MAGIC) ||
+			((header[6] | (header[7] << 8)) != _flash_log_crc(0xFFFF, header, 6))) {
+			_flash_log_erases[s] = 0;
+			continue;
+		}
+		_flash_log_state[s] = _FLASH_LOG_USED;
+		_flash_log_sequence[s] = header[2] | (header[3] << 8);
+		_flash_log_erases[s] = header[4] | (header[5] << 8);
+		if ((newest < 0) || ((int16_t)(_flash_log_sequence[s] - _flash_log_sequence[newest]) > 0))
+			newest = s;
+	}
+
+	// the log is the run of sectors, each one after the last, which ends at the newest
+	_flash_log_used = 0;
+	_flash_log_damaged = 0;
+	if (newest >= 0) {
+		uint8_t s = newest;
+		do {
+			_flash_log_tail = s;
+			_flash_log_used++;
+			s = _FLASH_LOG_PREV(s);
+		} while ((_flash_log_used < FLASH_LOG_SECTORS) && (_flash_log_state[s] == _FLASH_LOG_USED) &&
+				 (_flash_log_sequence[s] == (uint16_t)(_flash_log_sequence[_flash_log_tail] - 1)));
+		for (s = 0; s < FLASH_LOG_SECTORS; s++) {
+			// sectors from an older log are reused
+			if ((_flash_log_state[s] == _FLASH_LOG_USED) && ((uint16_t)(_flash_log_sequence[newest] - _flash_log_sequence[s]) >= _flash_log_used))
+				_flash_log_state[s] = _FLASH_LOG_DIRTY;
+		}
+
+		for (s = _flash_log_tail; ; s = _FLASH_LOG_NEXT(s)) {
+			_flash_log_write = _flash_log_walk(s, 0xFFFF, &(_flash_log_records[s]));
+			if (s == newest)
+				break;
+		}
+		_flash_log_head = newest;
+
+		// the power may have failed while the newest record was being written; it is marked so it is no longer counted
+		if (_flash_log_records[newest]) {
+			uint16_t skipped;
+			uint8_t length;
+			uint32_t address = _flash_log_find(_flash_log_walk(newest, _flash_log_records[newest] - 1, &skipped),
+											   _FLASH_LOG_ADDRESS(newest) + FLASH_SECTOR_SIZE, &length);
+			if (!_flash_log_intact(address, length)) {
+				uint8_t zero = 0;
+				flashWrite(address, &zero, 1);
+				_flash_log_records[newest]--;
+				_flash_log_write = (address | (FLASH_PAGE_SIZE - 1)) + 1;
+			}
+		}
+
+		// or while the space after it was being written
+		uint32_t page_end = (_flash_log_write | (FLASH_PAGE_SIZE - 1)) + 1;
+		if (!_flash_log_blank(_flash_log_write, page_end - _flash_log_write))
+			_flash_log_write = page_end;
+	} else {
+		_flash_log_head = FLASH_LOG_SECTORS - 1;	// the first record opens the first sector
+		_flash_log_write = _FLASH_LOG_ADDRESS(_flash_log_head) + FLASH_SECTOR_SIZE;
+	}
+
+	// the next sector is erased if it is blank, which saves erasing it again
+	uint8_t next = _FLASH_LOG_NEXT(_flash_log_head);
+	if ((_flash_log_state[next] == _FLASH_LOG_DIRTY) && _flash_log_blank(_FLASH_LOG_ADDRESS(next), FLASH_SECTOR_SIZE))
+		_flash_log_state[next] = _FLASH_LOG_FREE;
+
+	_flash_log_inited = true;
+	return true;
+}
+
+/* ---
+#### bool flashLogAppend(const uint8_t *data, uint8_t length)
+
+Add a record of 1 .. `FLASH_LOG_RECORD_MAX` bytes after the newest record.
+The record is copied and written by a FLASH job, as a single write of the record; see `flashJobPoll()`.
+It is counted once it is written.
+
+This only waits if the record before it is still waiting to be written, or when the current sector is full and the next sector
+is still being erased.
+
+Returns `false` if the record is not a valid size or could not be written.
+--- */
+
+bool flashLogAppend(const uint8_t *data, uint8_t length) {
+	if (!_flash_log_inited || !length || (length > FLASH_LOG_RECORD_MAX))
+		return false;
+
+	// a record does not cross a page
+	uint32_t page_end = (_flash_log_write | (FLASH_PAGE_SIZE - 1)) + 1;
+	if ((page_end - _flash_log_write) < (uint16_t)(FLASH_LOG_RECORD_HEADER + length))
+		_flash_log_write = page_end;
+
+	// a new sector may need a job to erase it as well as one to write the record
+	bool opening = (_flash_log_write >= (_FLASH_LOG_ADDRESS(_flash_log_head) + FLASH_SECTOR_SIZE));
+	if (!_flash_log_ready(opening ? 2 : 1))
+		return false;
+
+	uint8_t *record = _flash_log_buffers[(_flash_log_buffer_first + _flash_log_buffered) % FLASH_LOG_BUFFERS];
+	uint8_t *bp = record;
+
+	if (opening) {
+		// the next sector starts with its header, written along with the record; the jobs erase it first
+		uint8_t next = _FLASH_LOG_NEXT(_flash_log_head);
+		if (_flash_log_used && (next == _flash_log_tail))
+			_flash_log_drop_tail();
+		_flash_log_erase(next);
+
+		uint16_t sequence = _flash_log_used ? (_flash_log_sequence[_flash_log_head] + 1) : 0;
+		*bp++ = _FLASH_LOG_MAGIC & 0xFF;
+		*bp++ = _FLASH_LOG_MAGIC >> 8;
+		*bp++ = sequence & 0xFF;
+		*bp++ = sequence >> 8;
+		*bp++ = _flash_log_erases[next] & 0xFF;
+		*bp++ = _flash_log_erases[next] >> 8;
+		uint16_t crc = _flash_log_crc(0xFFFF, record, 6);
+		*bp++ = crc & 0xFF;
+		*bp++ = crc >> 8;
+
+		if (!_flash_log_used)
+			_flash_log_tail = next;
+		_flash_log_used++;
+		_flash_log_head = next;
+		_flash_log_sequence[next] = sequence;
+		_flash_log_records[next] = 0;
+		_flash_log_state[next] = _FLASH_LOG_USED;
+		_flash_log_write = _FLASH_LOG_ADDRESS(next);
+	}
+
+	uint16_t crc = _flash_log_crc(_crc_ccitt_update(0xFFFF, length), data, length);
+	*bp++ = length;
+	*bp++ = crc & 0xFF;
+	*bp++ = crc >> 8;
+	memcpy(bp, data, length);
+	bp += length;
+
+	if (!flashJobWrite(_flash_log_write, record, bp - record, _flash_log_written))
+		return false;
+	_flash_log_buffer_sector[(_flash_log_buffer_first + _flash_log_buffered) % FLASH_LOG_BUFFERS] = _flash_log_head;
+	_flash_log_buffered++;
+	_flash_log_write += bp - record;
+	return true;
+}
+
+/* ---
+#### void flashLogPoll()
+
+Start erasing the spare sector, ahead of the newest records, as a FLASH job. Call it regularly, eg: each time through the main loop,
+along with `flashJobPoll()`.
+--- */
+
+void flashLogPoll() {
+	if (!_flash_log_inited)
+		return;
+
+	uint8_t next = _FLASH_LOG_NEXT(_flash_log_head);
+	if (_flash_log_state[next] == _FLASH_LOG_FREE)
+		return;
+	if (_flash_log_used && (next == _flash_log_tail))
+		_flash_log_drop_tail();
+	_flash_log_erase(next);
+}
+
+/* ---
+#### uint16_t flashLogCount()
+
+Return the number of records in the log.
+--- */
+
+uint16_t flashLogCount() {
+	uint16_t count = 0;
+	for (uint8_t s = 0; s < FLASH_LOG_SECTORS; s++) {
+		if (_flash_log_state[s] == _FLASH_LOG_USED)
+			count += _flash_log_records[s];
+	}
+	return count;
+}
+
+/* ---
+Records are read with a `FLASHLOGCURSOR`, from an older record towards the newest:
+```C
+*/
+typedef struct _FLASHLOGCURSOR {
+	uint8_t sector;
+	uint16_t left;		// records left in the sector
+	uint32_t address;	// the next record
+} FLASHLOGCURSOR;
+/*
+```
+--- */
+
+/* ---
+#### bool flashLogSeek(FLASHLOGCURSOR *cursor, uint16_t age)
+
+Point the cursor at the record `age` records older than the newest; 0 is the newest record.
+Only the sector holding the record is read.
+
+Returns `false` if there are not that many records, or the FLASH chip is busy with a job and can not be read; try again later.
+
+eg: show the last 10 records, oldest first
+```C
+FLASHLOGCURSOR cursor;
+uint8_t line[FLASH_LOG_RECORD_MAX + 1];
+int length;
+if (flashLogSeek(&cursor, 9) || flashLogSeek(&cursor, flashLogCount() - 1)) {
+	while ((length = flashLogNext(&cursor, line, FLASH_LOG_RECORD_MAX)) >= 0) {
+		line[length] = 0;
+		uiPaneAdd((char *)line);
+	}
+}
+```
+--- */
+
+bool flashLogSeek(FLASHLOGCURSOR *cursor, uint16_t age) {
+	if (!_flash_log_inited || !_flash_log_used || flashBusy())
+		return false;
+
+	uint8_t sector = _flash_log_head;
+	for (uint8_t i = 0; i < _flash_log_used; i++) {
+		uint16_t records = _flash_log_records[sector];
+		if (age < records) {
+			uint16_t skipped;
+			cursor->sector = sector;
+			cursor->address = _flash_log_walk(sector, records - 1 - age, &skipped);
+			cursor->left = age + 1;
+			return true;
+		}
+		age -= records;
+		sector = _FLASH_LOG_PREV(sector);
+	}
+	return false;
+}
+
+/* ---
+#### int flashLogNext(FLASHLOGCURSOR *cursor, uint8_t *data, uint8_t size)
+
+Read the record at the cursor into `data`, up to `size` bytes, and move the cursor to the next newer record.
+Damaged records are skipped.
+
+Returns the length of the record, or -1 when there are no newer records or the FLASH chip is busy.
+Jobs only start in `flashJobPoll()`, so the chip does not become busy while the records are read one after the other.
+--- */
+
+int flashLogNext(FLASHLOGCURSOR *cursor, uint8_t *data, uint8_t size) {
+	uint8_t header[FLASH_LOG_RECORD_HEADER];
+
+	if (flashBusy())
+		return -1;
+
+	while (true) {
+		if (!cursor->left) {
+			// the first record of the next sector
+			if (cursor->sector == _flash_log_head)
+				return -1;
+			cursor->sector = _FLASH_LOG_NEXT(cursor->sector);
+			cursor->left = _flash_log_records[cursor->sector];
+			cursor->address = _FLASH_LOG_ADDRESS(cursor->sector) + _FLASH_LOG_HEADER;
+			continue;
+		}
+
+		uint32_t end = _FLASH_LOG_ADDRESS(cursor->sector) + FLASH_SECTOR_SIZE;
+		uint8_t length;
+		cursor->address = _flash_log_find(cursor->address, end, &length);
+		if (cursor->address >= end) {
+			cursor->left = 0;
+			continue;
+		}
+		SRXEFlashRead(cursor->address, header, FLASH_LOG_RECORD_HEADER);
+
+		uint32_t address = cursor->address + FLASH_LOG_RECORD_HEADER;
+		cursor->address = address + length;
+		cursor->left--;
+
+		// the CRC covers the whole record, even the part which does not fit in 'data'
+		uint8_t count = (length < size) ? length : size;
+		SRXEFlashRead(address, data, count);
+		uint16_t crc = _flash_log_crc(_crc_ccitt_update(0xFFFF, length), data, count);
+		for (uint8_t i = count; i < length; i++) {
+			uint8_t b;
+			SRXEFlashRead(address + i, &b, 1);
+			crc = _crc_ccitt_update(crc, b);
+		}
+		if (crc != (header[1] | (header[2] << 8))) {
+			_flash_log_damaged++;
+			continue;
+		}
+		return count;
+	}
+}
+
+/* ---
+#### uint16_t flashLogErases()
+
+Return the most times any sector of the log has been erased. The FLASH chip is good for at least 100,000 erases of each sector.
+--- */
+
+uint16_t flashLogErases() {
+	uint16_t most = 0;
+	for (uint8_t s = 0; s < FLASH_LOG_SECTORS; s++) {
+		if (_flash_log_erases[s] > most)
+			most = _flash_log_erases[s];
+	}
+	return most;
+}
+
+#endif // __SRXE_FLASHLOG_
@@ -0,0 +1,234 @@
+/* ************************************************************************************
+* File:    flashread.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### FLASH Reading
+**Streamed Reads and a Page Cache for the FLASH Chip**
+
+`SRXEFlashRead()` sends a read command and a 3 byte address for every call, which costs more than the data
+when many small pieces are read, eg: stepping through records or the glyphs of a font.
+
+A `FLASHREADER` is a cursor which reads on from where it left off. It leaves the FLASH chip selected between calls,
+so the next call just clocks out more data; the command and address are only sent again when another device,
+eg: the LCD, has used the SPI bus, or the reader has moved.
+
+The page cache keeps copies of the most recently used 256 byte pages in RAM, for reads which jump about within a few pages,
+eg: looking up an index. The least recently used page is replaced. Any erase or write of the FLASH chip empties the cache.
+
+The cache is set at compile time:
+```C
+*/
+#ifndef FLASH_CACHE_PAGES
+#define FLASH_CACHE_PAGES	2		// pages kept in RAM; 1 .. 8, each takes 256 bytes of RAM
+#endif
+/*
+```
+
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_FLASHREAD_
+#define __SRXE_FLASHREAD_
+
+#include "common.h"
+#include "flash.h"
+
+/* ---
+A reader is a `FLASHREADER`:
+```C
+*/
+typedef struct _FLASHREADER {
+	uint32_t addr;		// the next byte to read
+} FLASHREADER;
+/*
+```
+--- */
+
+#define _FLASH_READ_NONE	0xFFFFFFFFL
+
+static uint32_t _flash_read_stream = _FLASH_READ_NONE;	// the next byte of the open read; none when the FLASH chip is not selected
+
+// registered with common.h to end the open read when another device uses the SPI bus
+static void _flash_read_end() {
+	srxeDigitalWrite(FLASH_CS, HIGH);
+	_flash_read_stream = _FLASH_READ_NONE;
+}
+
+// the open read continues from 'addr', or a new one starts there
+static bool _flash_read_stream_at(uint32_t addr) {
+	if (_flash_read_stream == addr)
+		return true;
+	_srxe_spi_claim();
+	if (_flash_pending && (_flash_status() & 1))
+		return false;	// the chip can not be read while it erases or writes
+
+	_flash_command(0x0B, addr); // FAST_READ
+	_srxe_spi_transfer(0); // a dummy byte follows the address
+	_flash_read_stream = addr;
+	_srxe_spi_release = _flash_read_end;
+	return true;
+}
+
+
+/* ---
+#### void flashReaderOpen(FLASHREADER *reader, uint32_t addr)
+
+Start a reader at `addr`. Nothing is read until `flashReaderRead()`.
+--- */
+
+void flashReaderOpen(FLASHREADER *reader, uint32_t addr) {
+	reader->addr = addr;
+}
+
+/* ---
+#### bool flashReaderRead(FLASHREADER *reader, uint8_t *buffer, uint16_t count)
+
+Read the next `count` bytes into `buffer`. Reading past the end of the FLASH chip wraps around to the start.
+
+Returns `false`, and reads nothing, while the FLASH chip is erasing or writing.
+--- */
+
+bool flashReaderRead(FLASHREADER *reader, uint8_t *buffer, uint16_t count) {
+	if (!_flash_read_stream_at(reader->addr & (FLASH_SIZE - 1)))
+		return false;
+	for (uint16_t i = 0; i < count; i++)
+		buffer[i] = _srxe_spi_transfer(0);
+	reader->addr = (reader->addr + count) & (FLASH_SIZE - 1);
+	_flash_read_stream = reader->addr;
+	return true;
+}
+
+/* ---
+#### uint32_t flashReaderTell(FLASHREADER *reader)
+
+Return the address of the next byte the reader will read.
+--- */
+
+uint32_t flashReaderTell(FLASHREADER *reader) {
+	return reader->addr;
+}
+
+/* ---
+#### void flashReaderClose(FLASHREADER *reader)
+
+End the read, so the FLASH chip is no longer selected. This is optional; any use of the SPI bus by another device ends it.
+--- */
+
+void flashReaderClose(FLASHREADER *reader) {
+	(void)reader;
+	_srxe_spi_claim();
+}
+
+
+static uint8_t _flash_cache_data[FLASH_CACHE_PAGES][FLASH_PAGE_SIZE];
+static uint32_t _flash_cache_page[FLASH_CACHE_PAGES];	// the address of each page; none when it is not in use
+static uint8_t _flash_cache_age[FLASH_CACHE_PAGES];		// 0 is the most recently used
+static uint32_t _flash_cache_changes;					// _flash_changes when the pages were read
+static bool _flash_cache_inited;
+static uint32_t _flash_cache_hits;
+static uint32_t _flash_cache_misses;
+
+static void _flash_cache_empty() {
+	for (uint8_t i = 0; i < FLASH_CACHE_PAGES; i++) {
+		_flash_cache_page[i] = _FLASH_READ_NONE;
+		_flash_cache_age[i] = i;
+	}
+	_flash_cache_changes = _flash_changes;
+	_flash_cache_inited = true;
+}
+
+// the page becomes the most recently used
+static void _flash_cache_use(uint8_t page) {
+	for (uint8_t i = 0; i < FLASH_CACHE_PAGES; i++) {
+		if (_flash_cache_age[i] < _flash_cache_age[page])
+			_flash_cache_age[i]++;
+	}
+	_flash_cache_age[page] = 0;
+}
+
+/* ---
+#### const uint8_t* flashCachePage(uint32_t addr)
+
+Return the 256 bytes of the page which holds `addr`, from the cache or read into it.
+The data is only good until the next call to a cache function.
+
+Returns NULL while the FLASH chip is erasing or writing.
+--- */
+
+const uint8_t *flashCachePage(uint32_t addr) {
+	uint8_t oldest = 0;
+
+	if (!_flash_cache_inited || (_flash_cache_changes != _flash_changes))
+		_flash_cache_empty();
+
+	addr &= (FLASH_SIZE - 1) & ~((uint32_t)FLASH_PAGE_SIZE - 1);
+	for (uint8_t i = 0; i < FLASH_CACHE_PAGES; i++) {
+		if (_flash_cache_page[i] == addr) {
+			_flash_cache_hits++;
+			_flash_cache_use(i);
+			return _flash_cache_data[i];
+		}
+		if (_flash_cache_age[i] > _flash_cache_age[oldest])
+			oldest = i;
+	}
+
+	FLASHREADER reader;
+	flashReaderOpen(&reader, addr);
+	if (!flashReaderRead(&reader, _flash_cache_data[oldest], FLASH_PAGE_SIZE))
+		return NULL;
+	_flash_cache_misses++;
+	_flash_cache_page[oldest] = addr;
+	_flash_cache_use(oldest);
+	return _flash_cache_data[oldest];
+}
+
+/* ---
+#### bool flashCacheRead(uint32_t addr, uint8_t *buffer, uint16_t count)
+
+Read `count` bytes through the cache, as `SRXEFlashRead()` does. The data may cross pages.
+
+Returns `false` while the FLASH chip is erasing or writing.
+--- */
+
+bool flashCacheRead(uint32_t addr, uint8_t *buffer, uint16_t count) {
+	while (count) {
+		const uint8_t *page = flashCachePage(addr);
+		if (!page)
+			return false;
+		uint16_t offset = addr & (FLASH_PAGE_SIZE - 1);
+		uint16_t length = FLASH_PAGE_SIZE - offset;
+		if (length > count)
+			length = count;
+		memcpy(buffer, page + offset, length);
+		buffer += length;
+		addr += length;
+		count -= length;
+	}
+	return true;
+}
+
+/* ---
+#### uint8_t flashCacheHitRate(bool reset)
+
+Return the percent of the pages asked of the cache which it already held, and start counting over when `reset` is true.
+Use it to choose `FLASH_CACHE_PAGES`.
+--- */
+
+uint8_t flashCacheHitRate(bool reset) {
+	uint32_t total = _flash_cache_hits + _flash_cache_misses;
+	uint8_t rate = total ? (uint8_t)((_flash_cache_hits * 100) / total) : 0;
+	if (reset) {
+		_flash_cache_hits = 0;
+		_flash_cache_misses = 0;
+	}
+	return rate;
+}
+
+#endif // __SRXE_FLASHREAD_
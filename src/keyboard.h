@@ -168,20 +168,68 @@ uint8_t _kbd_symbol_keys[] = {
 --- */
 
 
-const uint8_t _kb_row_pins[ROWS] = {0xe6, 0xb7, 0xb6, 0xb5, 0xb4, 0xe0};
-const uint8_t _kb_col_pins[COLS] = {0xe4, 0xf1, 0xf3, 0xe2, 0xe1, 0xd7, 0xa0, 0xa5, 0xd5, 0xd4};
+// the keyboard pin codes are constants so the scan compiles to direct port instructions
+#define KBD_ROW0	0xe6
+#define KBD_ROW1	0xb7
+#define KBD_ROW2	0xb6
+#define KBD_ROW3	0xb5
+#define KBD_ROW4	0xb4
+#define KBD_ROW5	0xe0
+
+#define KBD_COL0	0xe4
+#define KBD_COL1	0xf1
+#define KBD_COL2	0xf3
+#define KBD_COL3	0xe2
+#define KBD_COL4	0xe1
+#define KBD_COL5	0xd7
+#define KBD_COL6	0xa0
+#define KBD_COL7	0xa5
+#define KBD_COL8	0xd5
+#define KBD_COL9	0xd4
+
+const uint8_t _kb_row_pins[ROWS] = {KBD_ROW0, KBD_ROW1, KBD_ROW2, KBD_ROW3, KBD_ROW4, KBD_ROW5};
+const uint8_t _kb_col_pins[COLS] = {KBD_COL0, KBD_COL1, KBD_COL2, KBD_COL3, KBD_COL4, KBD_COL5, KBD_COL6, KBD_COL7, KBD_COL8, KBD_COL9};
 static uint8_t _new_keymap[COLS];					  // bits indicating pressed keys
 static uint8_t _old_keymap[COLS];					  // previous map to look for pressed/released keys
 static uint16_t _last_key;							  // most recent key detected by scan
 
 static uint32_t _kb_debounce;
 #define KBD_DEBOUNCE_INTERVAL 10 // milliseconds
+#define KBD_SETTLE_US 2			// time for the rows to follow a column being pulled LOW
+
+// a pressed key pulls its row LOW
+#define _KBD_ROW(n, pin)	((srxeDigitalRead(pin) == LOW) ? (1 << (n)) : 0)
+
+#define _KBD_SCAN_COL(col, pin) { \
+	srxePinMode(pin, OUTPUT);		/* make the column GND */ \
+	srxeDigitalWrite(pin, LOW); \
+	_delay_us(KBD_SETTLE_US); \
+	_new_keymap[col] = _KBD_ROW(0, KBD_ROW0) | _KBD_ROW(1, KBD_ROW1) | _KBD_ROW(2, KBD_ROW2) | \
+					   _KBD_ROW(3, KBD_ROW3) | _KBD_ROW(4, KBD_ROW4) | _KBD_ROW(5, KBD_ROW5); \
+	srxeDigitalWrite(pin, HIGH);	/* reset the column to non-conductive */ \
+	srxePinMode(pin, INPUT); \
+}
+
+//
+// Read every key into the key map; the loops are unrolled so every pin code is a constant
+//
+static void _kbd_scan_matrix(void) {
+	_KBD_SCAN_COL(0, KBD_COL0);
+	_KBD_SCAN_COL(1, KBD_COL1);
+	_KBD_SCAN_COL(2, KBD_COL2);
+	_KBD_SCAN_COL(3, KBD_COL3);
+	_KBD_SCAN_COL(4, KBD_COL4);
+	_KBD_SCAN_COL(5, KBD_COL5);
+	_KBD_SCAN_COL(6, KBD_COL6);
+	_KBD_SCAN_COL(7, KBD_COL7);
+	_KBD_SCAN_COL(8, KBD_COL8);
+	_KBD_SCAN_COL(9, KBD_COL9);
+}
+
 //
 // Scan the rows and columns and store the results in the key map
 //
 void _kbd_scan_kb(void) {
-	uint8_t col, row;
-
 	// save current keymap to compare for pressed/released keys
 	memcpy(_old_keymap, _new_keymap, sizeof(_new_keymap));
 
@@ -195,20 +243,7 @@ void _kbd_scan_kb(void) {
 	}
 	#endif
 
-	for (col = 0; col < COLS; col++) {
-		_new_keymap[col] = 0;
-		srxePinMode(_kb_col_pins[col], OUTPUT); // make the column GND
-		srxeDigitalWrite(_kb_col_pins[col], LOW);
-
-		for (row = 0; row < ROWS; row++) {
-			if (srxeDigitalRead(_kb_row_pins[row]) == LOW) {
-				_new_keymap[col] |= (1 << row); // set a bit for this pressed key
-			}
-		} // for r
-
-		srxeDigitalWrite(_kb_col_pins[col], HIGH); // reset the column to non-conductive
-		srxePinMode(_kb_col_pins[col], INPUT);
-	} // for c
+	_kbd_scan_matrix();
 
 #if 1	// prioritize the center pad of the NAV buttons
 	// treat multi-NAV (aka button mashing) activation as ENTER
@@ -363,6 +398,10 @@ if no key _(or no new key)_ is pressed, it will wait.
 uint8_t kbdGetKeyWait() {
 	uint8_t c;
 
+#ifdef __SRXE_LCDDEFER_
+	// nothing more will be drawn until there is a key so show what has been drawn so far
+	lcdFlush();
+#endif
 	while (!(c = kbdGetKey()))
 		;
 	return c;
@@ -71,7 +71,7 @@ typedef struct _FONTOBJECT {
 	uint8_t height;
 	uint8_t widthbytes;
 	uint8_t charbytes;
-	uint8_t scale;	// a bit field
+	uint8_t scale;	// a bit field; the low bits are the scale and the high bits are the format flags
 } FONTOBJECT;
 
 enum {
@@ -84,13 +84,26 @@ enum {
 #define FONTS_MAX 4
 FONTOBJECT _srxe_fonts[FONTS_MAX];
 
-// definitions for 2X scaling a font width and/or height
-// the code can actually perform any multiple but 2X is pretyt much the only practical use case
+// definitions for scaling a font width and/or height
+// the width and height multipliers are 1X thru 4X and are stored as (multiplier - 1) in two bits each
 
-#define FONT_DEFAULT_SCALE 0x0
-#define FONT_DOUBLE_WIDTH 0x1
-#define FONT_DOUBLE_HEIGHT 0x2
-#define FONT_DOUBLED (FONT_DOUBLE_WIDTH | FONT_DOUBLE_HEIGHT)
+#define FONT_SCALE(w, h)	((((w) - 1) & 0x3) | ((((h) - 1) & 0x3) << 2))
+#define FONT_SCALE_WIDTH(s)	(((s) & 0x3) + 1)
+#define FONT_SCALE_HEIGHT(s)	((((s) >> 2) & 0x3) + 1)
+
+#define FONT_DEFAULT_SCALE FONT_SCALE(1, 1)
+#define FONT_DOUBLE_WIDTH FONT_SCALE(2, 1)
+#define FONT_DOUBLE_HEIGHT FONT_SCALE(1, 2)
+#define FONT_DOUBLED FONT_SCALE(2, 2)
+#define FONT_TRIPLED FONT_SCALE(3, 3)
+#define FONT_QUADRUPLED FONT_SCALE(4, 4)
+
+#define FONT_SCALE_MASK	0x0F
+
+// font format flags share the scale bit field
+
+#define FONT_NATIVE		0x10	// data is already packed as LCD triplets (font_gen.py native mode) and is only drawn at 1X
+#define FONT_GREYSCALE	0x20	// native data has its own 2-bit shading and ignores the current colors
 
 // --------------------------------------------------------------------------------------------
 
@@ -128,7 +141,7 @@ uint8_t _srxe_active_font_num;
 
 // --------------------------------------------------------------------------------------------
 
-static uint8_t _lcd_scroll_offset, _lcd_scroll_area;
+static uint8_t _lcd_scroll_offset, _lcd_scroll_top, _lcd_scroll_area;
 
 // --------------------------------------------------------------------------------------------
 
@@ -227,13 +240,27 @@ typedef enum {
 
 // Sets the D/C pin to data or command mode
 static void _lcd_set_mode(int iMode) {
-	srxeDigitalWrite(LCD_DC, (iMode == MODE_DATA));
+	if (iMode == MODE_DATA)
+		srxeDigitalWrite(LCD_DC, HIGH);
+	else
+		srxeDigitalWrite(LCD_DC, LOW);
 } /* _lcd_set_mode() */
 
+// The deferred drawing hook is installed by lcddefer.h while drawing is being deferred.
+// It is called with LCD_DEFER_COMMAND before any command is sent to the LCD, so everything deferred is drawn first,
+// and with LCD_DEFER_FILL by lcdFill(); it returns true when the fill has been deferred.
+#define LCD_DEFER_COMMAND	0
+#define LCD_DEFER_FILL		1
+static bool (*_lcd_defer_hook)(uint8_t op, uint8_t b);
+
 //
 // Write a one byte command to the LCD controller
 //
 static void _lcd_write_command(unsigned char c) {
+	if (_lcd_defer_hook)
+		_lcd_defer_hook(LCD_DEFER_COMMAND, c);
+
+	_srxe_spi_claim();
 	srxeDigitalWrite(LCD_CS, LOW);
 	_lcd_set_mode(MODE_COMMAND);
 	_srxe_spi_transfer(c);
@@ -243,15 +270,84 @@ static void _lcd_write_command(unsigned char c) {
 
 // Write a block of data to the LCD
 // Length can be anything from 1 to 17404 (whole display)
-void _lcd_write_data_block(uint8_t* data, uint8_t len) {
+void _lcd_write_data_block(uint8_t* data, uint16_t len) {
+	_srxe_spi_claim();
 	srxeDigitalWrite(LCD_CS, LOW);
-	for (uint8_t i = 0; i < len; i++) {
+	for (uint16_t i = 0; i < len; i++) {
 		_srxe_spi_transfer(data[i]);
 		LCD_STREAM_GRABBER(data[i]);
 	}
 	srxeDigitalWrite(LCD_CS, HIGH);
 }
 
+// Hold the LCD selected so any number of bytes may be streamed with _lcd_write_data_byte()
+// this avoids toggling CS between blocks which all belong to the same active area
+static inline void _lcd_write_data_begin() {
+	_srxe_spi_claim();
+	srxeDigitalWrite(LCD_CS, LOW);
+}
+
+static inline void _lcd_write_data_byte(uint8_t b) {
+	_srxe_spi_transfer(b);
+	LCD_STREAM_GRABBER(b);
+}
+
+static inline void _lcd_write_data_end() {
+	srxeDigitalWrite(LCD_CS, HIGH);
+}
+
+// Write a block of PROGMEM data to the LCD
+void _lcd_write_data_block_P(const uint8_t* data, uint16_t len) {
+	_srxe_spi_claim();
+	srxeDigitalWrite(LCD_CS, LOW);
+	for (uint16_t i = 0; i < len; i++) {
+		uint8_t b = pgm_read_byte(data + i);
+		_srxe_spi_transfer(b);
+		LCD_STREAM_GRABBER(b);
+	}
+	srxeDigitalWrite(LCD_CS, HIGH);
+}
+
+
+// --------------------------------------------------------------------------------------------
+// Burst writes
+//
+// Fills and lines send the same byte (or a short pattern) many times.
+// The burst functions stream directly to SPDR, 4 bytes per loop, with no RAM buffer and without the function call
+// per byte of _srxe_spi_transfer(). They must be used between _lcd_write_data_begin() and _lcd_write_data_end()
+// so the LCD stays selected for the whole window.
+
+#define _LCD_BURST_SEND(b)	{ SPDR = (b); asm volatile("nop"); while (!(SPSR & (1 << SPIF))); LCD_STREAM_GRABBER(b); }
+
+static void _lcd_burst_repeat(uint8_t b, uint16_t count) {
+	for (; count >= 4; count -= 4) {
+		_LCD_BURST_SEND(b);
+		_LCD_BURST_SEND(b);
+		_LCD_BURST_SEND(b);
+		_LCD_BURST_SEND(b);
+	}
+	while (count--)
+		_LCD_BURST_SEND(b);
+}
+
+// send 'count' bytes by repeating a RAM pattern of 'length' bytes
+static void _lcd_burst_pattern(const uint8_t *pattern, uint8_t length, uint16_t count) {
+	uint8_t i = 0;
+	while (count--) {
+		_LCD_BURST_SEND(pattern[i]);
+		if (++i >= length)
+			i = 0;
+	}
+}
+
+// Write the same byte 'count' times to the LCD
+// Length can be anything from 1 to 17408 (whole display)
+void _lcd_write_data_repeat(uint8_t b, uint16_t count) {
+	_lcd_write_data_begin();
+	_lcd_burst_repeat(b, count);
+	_lcd_write_data_end();
+}
+
 
 //
 // Power on the LCD; these are the ordered initialization commands
@@ -399,18 +495,38 @@ Fill the entire screen with the specified color.
 void lcdFill(uint8_t ucData) {
 	if (!_lcd_init) return;
 
-	int y;
-	uint8_t temp[128];
+	if (_lcd_defer_hook && _lcd_defer_hook(LCD_DEFER_FILL, ucData))
+		return;
 
 	LCD_STREAM_GRABBER_NEW();
 
 	_lcd_set_active_area(0, 0, LCD_WIDTH, LCD_HEIGHT);
 	LCD_STREAM_GRABBER_SKIP();	// we do not need to attempt and send all the blanking data
 
-	for (y = 0; y < LCD_HEIGHT; y++) {
-		memset(temp, ucData, LCD_WIDTH);		  // have to do this because the uint8_ts get overwritten
-		_lcd_write_data_block(temp, LCD_WIDTH); // fill with data uint8_t
-	}
+	_lcd_write_data_repeat(ucData, (uint16_t)LCD_WIDTH * LCD_HEIGHT);
+
+	_lcd_end_active_area();
+}
+
+/* ---
+#### void lcdFillPattern(const uint8_t *pattern, uint8_t length)
+
+Fill the entire screen by repeating a short pattern of triplets. Each row starts at the beginning of the pattern.
+This is useful for stripes and dithered backgrounds.
+--- */
+
+void lcdFillPattern(const uint8_t *pattern, uint8_t length) {
+	if (!_lcd_init || !length) return;
+
+	LCD_STREAM_GRABBER_NEW();
+
+	_lcd_set_active_area(0, 0, LCD_WIDTH, LCD_HEIGHT);
+	LCD_STREAM_GRABBER_SKIP();
+
+	_lcd_write_data_begin();
+	for (uint8_t y = 0; y < LCD_HEIGHT; y++)
+		_lcd_burst_pattern(pattern, length, LCD_WIDTH);
+	_lcd_write_data_end();
 
 	_lcd_end_active_area();
 }
@@ -681,7 +797,8 @@ int lcdInit() {
 	srxeDigitalWrite(LCD_RESET, HIGH); // take it out of reset
 	_delay_ms(150);						  // datasheet says it must be at least 120ms
 
-	_lcd_scroll_area = LCD_HEIGHT;
+	_lcd_scroll_top = 0;
+	_lcd_scroll_area = LCD_DRIVER_HEIGHT;
 
 	_lcd_init = true;
 
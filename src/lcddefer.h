@@ -0,0 +1,291 @@
+/* ************************************************************************************
+* File:	lcddefer.h
+* Date:	2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### LCD Deferred Drawing
+**Draw Once per Frame**
+
+Normally every draw function sends its pixels to the LCD immediately.
+When a screen is built up from overlapping pieces - erasing an area and then drawing on it,
+or drawing a bitmap and then covering part of it - the same pixels are sent more than once.
+
+While drawing is deferred, the rectangle, line, fill, bitmap, and text functions record what they would draw
+in a small display list. A new entry removes any earlier entries it completely covers and trims earlier
+solid fills it partly covers. Solid fills of the same color which line up are merged into one.
+`lcdFlush()` then draws what remains, in order, and is typically called once each time through the main loop.
+
+Anything else sent to the LCD - scrolling, contrast, sleep, etc. - first flushes the display list so the order of
+operations is preserved. `kbdGetKeyWait()` also flushes before it waits.
+
+The size of the display list is set at compile time:
+```C
+*/
+#ifndef LCD_DEFER_OPS
+#define LCD_DEFER_OPS	32		// maximum number of deferred draw operations; the list is flushed when it is full
+#endif
+#ifndef LCD_DEFER_POOL
+#define LCD_DEFER_POOL	128		// bytes of SRAM for deferred text
+#endif
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_LCDDEFER_
+#define __SRXE_LCDDEFER_
+
+#include "common.h"
+#include "lcdbase.h"
+
+#define LCD_WINDOW_COST	11		// SPI bytes to open an LCD window (3 commands and 8 parameter bytes)
+
+// each operation is an area of the LCD and the function which draws it
+// the meaning of 'a', 'b', and 'data' belongs to the draw function
+
+typedef struct _LCDOP {
+	void (*draw)(struct _LCDOP *op);
+	uint8_t x, y, cx, cy;	// x and cx are in triplets
+	uint8_t a, b;
+	const void *data;
+} LCDOP;
+
+static LCDOP _lcd_defer_ops[LCD_DEFER_OPS];
+static uint8_t _lcd_defer_count;
+static uint8_t _lcd_defer_pool[LCD_DEFER_POOL];
+static uint8_t _lcd_defer_pool_used;
+
+static uint32_t _lcd_defer_recorded;		// SPI bytes the recorded operations would have sent if drawn immediately
+static uint32_t _lcd_defer_saved;			// total SPI bytes saved by all flushes
+static uint16_t _lcd_defer_saved_last;		// SPI bytes saved by the most recent flush
+
+void lcdFlush();
+
+static inline bool _lcd_defer_covers(uint8_t x, uint8_t y, uint8_t cx, uint8_t cy, LCDOP *op) {
+	return (op->x >= x) && ((op->x + op->cx) <= (x + cx)) && (op->y >= y) && ((op->y + op->cy) <= (y + cy));
+}
+
+// a solid fill; 'a' is the triplet byte
+static void _lcd_defer_draw_fill(LCDOP *op) {
+	_lcd_set_active_area(op->x, op->y, op->cx, op->cy);
+	_lcd_write_data_repeat(op->a, op->cx * op->cy);
+	_lcd_end_active_area();
+}
+
+// a new operation paints over this area; drop what it hides and trim solid fills it partly hides
+static void _lcd_defer_cull(uint8_t x, uint8_t y, uint8_t cx, uint8_t cy) {
+	uint8_t kept = 0;
+
+	for (uint8_t i = 0; i < _lcd_defer_count; i++) {
+		LCDOP *op = &(_lcd_defer_ops[i]);
+
+		if (_lcd_defer_covers(x, y, cx, cy, op))
+			continue;
+
+		if (op->draw == _lcd_defer_draw_fill) {
+			if ((y <= op->y) && ((y + cy) >= (op->y + op->cy))) {
+				// covers the full height; trim the left or right end
+				if ((x <= op->x) && ((x + cx) > op->x)) {
+					op->cx -= (x + cx) - op->x;
+					op->x = x + cx;
+				} else if ((x > op->x) && (x < (op->x + op->cx)) && ((x + cx) >= (op->x + op->cx))) {
+					op->cx = x - op->x;
+				}
+			} else if ((x <= op->x) && ((x + cx) >= (op->x + op->cx))) {
+				// covers the full width; trim the top or bottom
+				if ((y <= op->y) && ((y + cy) > op->y)) {
+					op->cy -= (y + cy) - op->y;
+					op->y = y + cy;
+				} else if ((y > op->y) && (y < (op->y + op->cy)) && ((y + cy) >= (op->y + op->cy))) {
+					op->cy = y - op->y;
+				}
+			}
+		}
+
+		_lcd_defer_ops[kept++] = *op;
+	}
+	_lcd_defer_count = kept;
+}
+
+// true when deferring and the area is on the LCD; anything else is drawn immediately
+static inline bool _lcd_defer_fits(int x, int y, int cx, int cy) {
+	return _lcd_defer_hook && (x >= 0) && (y >= 0) && (cx > 0) && (cy > 0) && ((x + cx) <= LCD_WIDTH) && ((y + cy) <= LCD_DRIVER_HEIGHT);
+}
+
+// make room for one more operation with 'length' bytes of pool data; returns false if the pool could never hold it
+static bool _lcd_defer_room(uint8_t length) {
+	if (length > LCD_DEFER_POOL)
+		return false;
+	if ((_lcd_defer_count >= LCD_DEFER_OPS) || ((LCD_DEFER_POOL - _lcd_defer_pool_used) < length))
+		lcdFlush();
+	return true;
+}
+
+// returns the most recent operation, if it is drawn by the given function
+static LCDOP *_lcd_defer_last(void (*draw)(LCDOP *op)) {
+	if (_lcd_defer_count && (_lcd_defer_ops[_lcd_defer_count - 1].draw == draw))
+		return &(_lcd_defer_ops[_lcd_defer_count - 1]);
+	return NULL;
+}
+
+// record a new operation; 'bytes' is what drawing it immediately would have sent
+static LCDOP *_lcd_defer_add(void (*draw)(LCDOP *op), uint8_t x, uint8_t y, uint8_t cx, uint8_t cy, uint16_t bytes) {
+	if (_lcd_defer_count >= LCD_DEFER_OPS)
+		lcdFlush();
+
+	_lcd_defer_cull(x, y, cx, cy);
+	_lcd_defer_recorded += bytes;
+
+	LCDOP *op = &(_lcd_defer_ops[_lcd_defer_count++]);
+	op->draw = draw;
+	op->x = x;
+	op->y = y;
+	op->cx = cx;
+	op->cy = cy;
+	op->a = op->b = 0;
+	op->data = NULL;
+	return op;
+}
+
+// reserve space in the pool for the data of an operation; returns NULL if there is not enough space
+static uint8_t *_lcd_defer_pool_alloc(uint8_t length) {
+	if ((LCD_DEFER_POOL - _lcd_defer_pool_used) < length)
+		return NULL;
+	uint8_t *p = &(_lcd_defer_pool[_lcd_defer_pool_used]);
+	_lcd_defer_pool_used += length;
+	return p;
+}
+
+// record a solid fill, merging it with the previous fill when the two make a single rectangle
+static bool _lcd_defer_fill(uint8_t b, uint8_t x, uint8_t y, uint8_t cx, uint8_t cy) {
+	if (!cx || !cy)
+		return true;
+
+	_lcd_defer_cull(x, y, cx, cy);
+
+	LCDOP *op = _lcd_defer_last(_lcd_defer_draw_fill);
+	if (op && (op->a == b)) {
+		if ((op->y == y) && (op->cy == cy) && (x <= (op->x + op->cx)) && ((x + cx) >= op->x)) {
+			uint8_t right = ((x + cx) > (op->x + op->cx)) ? (x + cx) : (op->x + op->cx);
+			op->x = (x < op->x) ? x : op->x;
+			op->cx = right - op->x;
+			_lcd_defer_recorded += (cx * cy) + LCD_WINDOW_COST;
+			return true;
+		}
+		if ((op->x == x) && (op->cx == cx) && (y <= (op->y + op->cy)) && ((y + cy) >= op->y)) {
+			uint8_t bottom = ((y + cy) > (op->y + op->cy)) ? (y + cy) : (op->y + op->cy);
+			op->y = (y < op->y) ? y : op->y;
+			op->cy = bottom - op->y;
+			_lcd_defer_recorded += (cx * cy) + LCD_WINDOW_COST;
+			return true;
+		}
+	}
+
+	op = _lcd_defer_add(_lcd_defer_draw_fill, x, y, cx, cy, (cx * cy) + LCD_WINDOW_COST);
+	op->a = b;
+	return true;
+}
+
+// installed as the lcdbase.h hook while deferring
+static bool _lcd_defer_lcdbase_hook(uint8_t op, uint8_t b) {
+	if (op == LCD_DEFER_FILL)
+		return _lcd_defer_fill(b, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+
+	// any other LCD command must wait for everything already deferred
+	if (_lcd_defer_count)
+		lcdFlush();
+	return false;
+}
+
+
+/* ---
+#### void lcdDeferBegin()
+
+Start deferring the draw functions. Nothing is sent to the LCD until `lcdFlush()`,
+the display list is full, or some other command is sent to the LCD.
+--- */
+
+void lcdDeferBegin() {
+	_lcd_defer_hook = _lcd_defer_lcdbase_hook;
+}
+
+/* ---
+#### void lcdDeferEnd()
+
+Flush anything deferred and return to drawing immediately.
+--- */
+
+void lcdDeferEnd() {
+	lcdFlush();
+	_lcd_defer_hook = NULL;
+}
+
+/* ---
+#### bool lcdDeferActive()
+
+Return true while drawing is being deferred.
+--- */
+
+bool lcdDeferActive() {
+	return (_lcd_defer_hook != NULL);
+}
+
+/* ---
+#### void lcdFlush()
+
+Draw everything in the display list. It is safe to call when nothing has been deferred.
+--- */
+
+void lcdFlush() {
+	if (!_lcd_defer_count)
+		return;
+
+	// the draw functions must draw immediately while the list is replayed
+	bool (*hook)(uint8_t op, uint8_t b) = _lcd_defer_hook;
+	_lcd_defer_hook = NULL;
+
+	uint32_t sent = 0;
+	for (uint8_t i = 0; i < _lcd_defer_count; i++) {
+		LCDOP *op = &(_lcd_defer_ops[i]);
+		op->draw(op);
+		sent += ((uint16_t)op->cx * op->cy) + LCD_WINDOW_COST;
+	}
+
+	_lcd_defer_saved_last = (_lcd_defer_recorded > sent) ? (_lcd_defer_recorded - sent) : 0;
+	_lcd_defer_saved += _lcd_defer_saved_last;
+
+	_lcd_defer_count = 0;
+	_lcd_defer_pool_used = 0;
+	_lcd_defer_recorded = 0;
+
+	_lcd_defer_hook = hook;
+}
+
+/* ---
+#### uint16_t lcdFlushBytesSaved()
+
+Return the number of SPI bytes the most recent `lcdFlush()` did not need to send
+compared to drawing everything immediately. Each LCD window is counted as 11 bytes.
+--- */
+
+uint16_t lcdFlushBytesSaved() {
+	return _lcd_defer_saved_last;
+}
+
+/* ---
+#### uint32_t lcdDeferBytesSaved()
+
+Return the total number of SPI bytes saved by all flushes.
+--- */
+
+uint32_t lcdDeferBytesSaved() {
+	return _lcd_defer_saved;
+}
+
+#endif // __SRXE_LCDDEFER_
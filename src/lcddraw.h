@@ -31,13 +31,13 @@ Draw a horizontal line with a given thickness.
 void lcdHorizontalLine(int x, int y, int length, int thickness) {
 	if (!_lcd_init) return;
 
-	uint8_t bTemp[128];
-	memset(bTemp, lcdColorTripletGetF(), length);
+#ifdef __SRXE_LCDDEFER_
+	if (_lcd_defer_fits(x, y, length, thickness) && _lcd_defer_fill(lcdColorTripletGetF(), x, y, length, thickness))
+		return;
+#endif
 
 	_lcd_set_active_area(x, y, length, thickness);
-	for (int i = 0; i < thickness; i++) {
-		_lcd_write_data_block(bTemp, length);
-	}
+	_lcd_write_data_repeat(lcdColorTripletGetF(), length * thickness);
 	_lcd_end_active_area();
 }
 
@@ -51,7 +51,6 @@ Draw a vertical line. Thickness from 1 to 3 is supported.
 
 void lcdVerticalLine(int x, int y, int height, int thickness) {
 	if (!_lcd_init) return;
-	uint8_t bTemp[136];
 
 	// implement thickness = try repeating entire instruction set first, then see if it can be optimized like with horizontal
 
@@ -64,13 +63,51 @@ void lcdVerticalLine(int x, int y, int height, int thickness) {
 
 	if (thickness == 1)	color = (fg & 0b00011100) | (bg & 0b11100011); // use middle pixel of triplet
 	if (thickness == 2)	color = (fg & 0b11111100) | (bg & 0b00000011); // use left and middle pixel of triplet
-	memset(bTemp, color, height);
+
+#ifdef __SRXE_LCDDEFER_
+	if (_lcd_defer_fits(x, y, 1, height) && _lcd_defer_fill(color, x, y, 1, height))
+		return;
+#endif
 
 	_lcd_set_active_area(x, y, 1, height);	// 1 = one triplet
-	_lcd_write_data_block(bTemp, height);
+	_lcd_write_data_repeat(color, height);
+	_lcd_end_active_area();
+}
+
+// a filled rectangle and its border are sent as one window
+static void _lcd_rectangle_filled(int x, int y, int cx, int cy, uint8_t fg, uint8_t bg) {
+	uint8_t left = (fg & 0b11100000) | (bg & 0b00011111);	// left pixel
+	uint8_t right = (fg & 0b00000011) | (bg & 0b11111100);	// right pixel
+
+	_lcd_set_active_area(x, y, cx, cy);
+	_lcd_write_data_begin();
+	for (uint8_t i = 0; i < cy; i++) {
+		if ((i == 0) || (i == (cy - 1))) {
+			_lcd_burst_repeat(fg, cx);				// top and bottom
+		} else if (cx == 1) {
+			_lcd_write_data_byte(right);
+		} else {
+			_lcd_write_data_byte(left);
+			_lcd_burst_repeat(bg, cx - 2);
+			_lcd_write_data_byte(right);
+		}
+	}
+	_lcd_write_data_end();
 	_lcd_end_active_area();
 }
 
+#ifdef __SRXE_LCDDEFER_
+static void _lcd_defer_draw_rectangle(LCDOP *op) {
+	_lcd_rectangle_filled(op->x, op->y, op->cx, op->cy, op->a, op->b);
+}
+
+void lcdBitmap(int x, int y, const uint8_t *btmp, bool invert);
+
+static void _lcd_defer_draw_bitmap(LCDOP *op) {
+	lcdBitmap(op->x, op->y, (const uint8_t *)op->data, op->a);
+}
+#endif
+
 /* ---
 #### void lcdRectangle(int x, int y, int width, int height, bool filled)
 
@@ -84,8 +121,6 @@ Vertical dimensions are always in real pixels.
 void lcdRectangle(int x, int y, int cx, int cy, uint8_t mode) {
 	if (!_lcd_init) return;
 
-	uint8_t bTemp[136];	// a full length vertical line is the maximum data block we will write
-
 #if 0
 	if (x < 0 || x > 127 || y < 0 || y > 135) return;
 	if (x + cx > 127 || y + cy > 135) return;
@@ -103,41 +138,53 @@ void lcdRectangle(int x, int y, int cx, int cy, uint8_t mode) {
 	fg = lcdColorTripletGetF();
 	bg = lcdColorTripletGetB();
 
-	if ((mode == LCD_FILLED) || (mode == LCD_ERASE)) {
-		_lcd_set_active_area(x, y, cx, cy);
-		for (uint8_t i = 0; i < cy; i++) {
-			memset(bTemp, bg, cx);
-			_lcd_write_data_block(bTemp, cx);
+	uint8_t left = (fg & 0b11100000) | (bg & 0b00011111);	// left pixel
+	uint8_t right = (fg & 0b00000011) | (bg & 0b11111100);	// right pixel
+
+#ifdef __SRXE_LCDDEFER_
+	if (_lcd_defer_fits(x, y, cx, cy)) {
+		if (mode == LCD_ERASE) {
+			_lcd_defer_fill(bg, x, y, cx, cy);
+		} else if (mode == LCD_FILLED) {
+			LCDOP *op = _lcd_defer_add(_lcd_defer_draw_rectangle, x, y, cx, cy, (cx * cy) + LCD_WINDOW_COST);
+			op->a = fg;
+			op->b = bg;
+		} else {
+			// the edges are recorded in the order they are drawn so the corners come out the same
+			_lcd_defer_fill(left, x, y, 1, cy);
+			_lcd_defer_fill(right, (x + cx) - 1, y, 1, cy);
+			_lcd_defer_fill(fg, x, y, cx, 1);
+			_lcd_defer_fill(fg, x, y + cy - 1, cx, 1);
 		}
-		_lcd_end_active_area();
+		return;
 	}
+#endif
 
-	uint8_t color; // color bit for a triplet
-	if (mode != LCD_ERASE) {
+	if (mode == LCD_ERASE) {
+		_lcd_set_active_area(x, y, cx, cy);
+		_lcd_write_data_repeat(bg, cx * cy);
+		_lcd_end_active_area();
+	} else if (mode == LCD_FILLED) {
+		_lcd_rectangle_filled(x, y, cx, cy, fg, bg);
+	} else {
 		// Left
 		_lcd_set_active_area(x, y, 1, cy);
-		color = (fg & 0b11100000) | (bg & 0b00011111);	// left pixel
-		memset(bTemp, color, cy);
-		_lcd_write_data_block(bTemp, cy);
+		_lcd_write_data_repeat(left, cy);
 		_lcd_end_active_area();
 
 		// Right
 		_lcd_set_active_area((x + cx) - 1, y, 1, cy);
-		color = (fg & 0b00000011) | (bg & 0b11111100);	// right pixel
-		memset(bTemp, color, cy);
-		_lcd_write_data_block(bTemp, cy);
+		_lcd_write_data_repeat(right, cy);
 		_lcd_end_active_area();
 
 		// Top
 		_lcd_set_active_area(x, y, cx, 1);
-		memset(bTemp, fg, cx);
-		_lcd_write_data_block(bTemp, cx);
+		_lcd_write_data_repeat(fg, cx);
 		_lcd_end_active_area();
 
 		// Bottom
 		_lcd_set_active_area(x, y + cy - 1, cx, 1);
-		memset(bTemp, fg, cx);
-		_lcd_write_data_block(bTemp, cx);
+		_lcd_write_data_repeat(fg, cx);
 		_lcd_end_active_area();
 	}
 
@@ -166,19 +213,25 @@ void lcdBitmap(int x, int y, const uint8_t *btmp, bool invert) {
 	width = pgm_read_byte_near(btmp + index++) + (pgm_read_byte_near(btmp + index++) << 8);
 	height = pgm_read_byte_near(btmp + index++) + (pgm_read_byte_near(btmp + index++) << 8);
 
+#ifdef __SRXE_LCDDEFER_
+	if (_lcd_defer_fits(x, y, TRIPLET_FROM_ACTUAL(width), height)) {
+		LCDOP *op = _lcd_defer_add(_lcd_defer_draw_bitmap, x, y, TRIPLET_FROM_ACTUAL(width), height, (TRIPLET_FROM_ACTUAL(width) * height) + LCD_WINDOW_COST);
+		op->a = invert;
+		op->data = btmp;
+		return;
+	}
+#endif
+
 	_lcd_set_active_area(x, y, TRIPLET_FROM_ACTUAL(width), height);
 
-	srxeDigitalWrite(LCD_CS, LOW);
+	_lcd_write_data_begin();
 	while ((length = pgm_read_byte_near(btmp + index++))) {
 		value = pgm_read_byte_near(btmp + index++);
 		if (invert)
 			value = ~value;
-		for (unsigned char count = 0; count < length; count++) {
-			_srxe_spi_transfer(value);
-			LCD_STREAM_GRABBER(value);
-		}
+		_lcd_burst_repeat(value, length);
 	}
-	srxeDigitalWrite(LCD_CS, HIGH);
+	_lcd_write_data_end();
 
 	_lcd_end_active_area();
 }
@@ -194,14 +247,16 @@ The parameters are:
  - int BA - number of pixel lines for the bottom fixed area
 
 The sum of TA + SA + BA must equal 160. 160 is the LCD driver height (not the LCD height).
+Only the first 136 lines are visible so the bottom fixed area must include the 24 hidden lines;
+eg: a fixed area at the bottom of the screen which is 20 lines tall needs `BA = 44`.
 
-**Warning:** This code has not been tested.
+The scroll position is reset.
 --- */
 void lcdScrollSet(int TA, int SA, int BA) {
 	if (!_lcd_init) return;
 	uint8_t cmd_buffer[3];
 
-	if ((TA + SA + BA) != 160)
+	if ((TA < 0) || (SA < 1) || (BA < 0) || ((TA + SA + BA) != LCD_DRIVER_HEIGHT))
 		return;
 
 	cmd_buffer[0] = (uint8_t)TA;
@@ -210,7 +265,12 @@ void lcdScrollSet(int TA, int SA, int BA) {
 	_lcd_write_command(0x33); // set scroll area
 	_lcd_write_data_block(cmd_buffer, 3);
 
+	_lcd_scroll_top = (uint8_t)TA;
 	_lcd_scroll_area = (uint8_t)SA;
+	_lcd_scroll_offset = 0;
+
+	_lcd_write_command(0x37); // set scroll start line
+	_lcd_write_data_block(&_lcd_scroll_top, 1);
 }
 
 /* ---
@@ -218,35 +278,44 @@ void lcdScrollSet(int TA, int SA, int BA) {
 
 Scroll the _scroll area_ a given number of pixel lines. The _scroll area_, `SA`,  must already be set using `lcdScrollSet()`.
 
-**Warning:** This code has not been tested.
+A positive count moves the content up. The line which was at the top of the scroll area wraps around to the bottom.
+Nothing is redrawn; only the new scroll position is sent to the LCD.
+
+Use `lcdScrollRow()` to find the LCD row which is currently shown at a given line of the scroll area.
 --- */
 void lcdScrollLines(int count) {
 	if (!_lcd_init) return;
 	uint8_t b;
 
-	//  _lcd_scroll_offset = (_lcd_scroll_offset + iLines) % LCD_HEIGHT;
+	count %= (int)_lcd_scroll_area;
+	if (count < 0)
+		count += _lcd_scroll_area;
 	_lcd_scroll_offset = (_lcd_scroll_offset + count) % _lcd_scroll_area;
+
+	// the start line is an LCD row within the scroll area, not an offset into the scroll area
 	_lcd_write_command(0x37); // set scroll start line
-	b = (uint8_t)_lcd_scroll_offset;
+	b = _lcd_scroll_top + _lcd_scroll_offset;
 	_lcd_write_data_block(&b, 1);
 } /* SRXEScroll() */
 
+/* ---
+#### uint8_t lcdScrollRow(uint8_t line)
+
+Return the LCD row which is currently shown at the given pixel line of the scroll area, where 0 is the top of the scroll area.
+Drawing at this row puts the graphics on the screen at that line.
+--- */
+uint8_t lcdScrollRow(uint8_t line) {
+	return _lcd_scroll_top + ((_lcd_scroll_offset + line) % _lcd_scroll_area);
+}
+
 /* ---
 #### void lcdScrollReset(int count)
 
 Reset the scroll area to the whole screen.
-
-**Warning:** This code has not been tested.
 --- */
 void lcdScrollReset(void) {
 	if (!_lcd_init) return;
-	uint8_t b;
-	lcdScrollSet(0, 160, 0); // restore default values
-
-	_lcd_scroll_offset = 0;
-	_lcd_write_command(0x37); // scroll start address
-	b = 0;
-	_lcd_write_data_block(&b, 1);
+	lcdScrollSet(0, LCD_DRIVER_HEIGHT, 0); // restore default values
 } /* SRXEcdScrollReset() */
 
 #endif // __SRXE_LCDDRAW_
@@ -22,6 +22,10 @@ To specify your own fonts, add `#define CUSTOM_FONTS` before including the libra
 you will need to sue the `lcdFontConfig()` function and optionally use `lcdFontClone()`.
 If `CUSTOM_FONTS` is not defined, the SRXEcore will load default fonts.
 
+Fonts may also be generated in the _native_ format. Native fonts are already packed as LCD triplets
+and are streamed straight to the LCD with no conversion. They use more flash and are only drawn at 1X.
+A native font is configured with `FONT_NATIVE` (and `FONT_GREYSCALE` when generated with shading) in the scale parameter.
+
 --------------------------------------------------------------------------
 --- */
 
@@ -34,6 +38,181 @@ If `CUSTOM_FONTS` is not defined, the SRXEcore will load default fonts.
 #include "lcdbase.h"
 
 
+/* ---
+#### Glyph Cache
+
+Converting a character from the 1-bit font data to LCD triplets is the most expensive part of drawing text.
+The status bar, input box, and chat lines redraw the same few characters over and over,
+so the converted triplets are kept in a small RAM cache and sent directly to the LCD when the same
+character is drawn again with the same font slot, scale, and colors.
+
+The cache uses least-recently-used eviction. Its size is set at compile time:
+```C
+*/
+#ifndef LCD_GLYPH_CACHE_SIZE
+#define LCD_GLYPH_CACHE_SIZE	1024	// bytes of SRAM for converted glyphs; 0 removes the cache entirely
+#endif
+#ifndef LCD_GLYPH_CACHE_ENTRIES
+#define LCD_GLYPH_CACHE_ENTRIES	32		// maximum number of glyphs held at one time
+#endif
+/*
+```
+For reference, a `FONT1` glyph uses 16 bytes, `FONT2` uses 36 bytes, `FONT3` uses 64 bytes, and `FONT4` uses 144 bytes.
+--- */
+
+// the cache key packs the font slot, colors, and character into 16 bits; the scale is stored alongside
+#define _LCD_GLYPH_KEY(font_id, fg, bg, c)	((((uint16_t)(font_id) & 0x3) << 11) | (((uint16_t)(fg) & 0x3) << 9) | (((uint16_t)(bg) & 0x3) << 7) | ((uint8_t)(c) & 0x7f))
+
+#if LCD_GLYPH_CACHE_SIZE
+
+typedef struct _GLYPHENTRY {
+	uint16_t key;
+	uint16_t offset;	// entries are kept in pool order so the pool never fragments
+	uint16_t length;
+	uint16_t stamp;		// last use; the smallest stamp is the least recently used
+	uint8_t scale;
+} GLYPHENTRY;
+
+static uint8_t _lcd_glyph_pool[LCD_GLYPH_CACHE_SIZE];
+static GLYPHENTRY _lcd_glyph_entries[LCD_GLYPH_CACHE_ENTRIES];
+static uint8_t _lcd_glyph_count;
+static uint16_t _lcd_glyph_used;
+static uint16_t _lcd_glyph_stamp;
+static uint16_t _lcd_glyph_pin;		// when set, glyphs used at or after this stamp are not evicted (used while drawing a string run)
+
+#endif
+
+static uint32_t _lcd_glyph_hits, _lcd_glyph_misses;
+
+#if LCD_GLYPH_CACHE_SIZE
+static uint16_t _lcd_glyph_cache_stamp() {
+	if (++_lcd_glyph_stamp == 0) {
+		// the stamp wrapped; age everything equally and start again
+		for (uint8_t i = 0; i < _lcd_glyph_count; i++)
+			_lcd_glyph_entries[i].stamp = 0;
+		_lcd_glyph_stamp = 1;
+	}
+	return _lcd_glyph_stamp;
+}
+
+// remove an entry and close the gap it leaves in the pool
+static void _lcd_glyph_cache_remove(uint8_t index) {
+	GLYPHENTRY *entry = &(_lcd_glyph_entries[index]);
+	uint16_t length = entry->length;
+	uint16_t end = entry->offset + length;
+
+	memmove(&(_lcd_glyph_pool[entry->offset]), &(_lcd_glyph_pool[end]), _lcd_glyph_used - end);
+	_lcd_glyph_used -= length;
+
+	for (uint8_t i = index + 1; i < _lcd_glyph_count; i++) {
+		_lcd_glyph_entries[i - 1] = _lcd_glyph_entries[i];
+		_lcd_glyph_entries[i - 1].offset -= length;
+	}
+	_lcd_glyph_count--;
+}
+
+static uint8_t *_lcd_glyph_cache_find(uint16_t key, uint8_t scale) {
+	for (uint8_t i = 0; i < _lcd_glyph_count; i++) {
+		GLYPHENTRY *entry = &(_lcd_glyph_entries[i]);
+		if ((entry->key == key) && (entry->scale == scale)) {
+			entry->stamp = _lcd_glyph_cache_stamp();
+			return &(_lcd_glyph_pool[entry->offset]);
+		}
+	}
+	return NULL;
+}
+
+// reserve space for a new glyph, evicting the least recently used glyphs as needed; returns NULL if the glyph can never fit
+static uint8_t *_lcd_glyph_cache_alloc(uint16_t key, uint8_t scale, uint16_t length) {
+	if (length > LCD_GLYPH_CACHE_SIZE)
+		return NULL;
+
+	while ((_lcd_glyph_count >= LCD_GLYPH_CACHE_ENTRIES) || ((_lcd_glyph_used + length) > LCD_GLYPH_CACHE_SIZE)) {
+		uint8_t oldest = _lcd_glyph_count;
+		for (uint8_t i = 0; i < _lcd_glyph_count; i++) {
+			if (_lcd_glyph_pin && (_lcd_glyph_entries[i].stamp >= _lcd_glyph_pin))
+				continue;
+			if ((oldest == _lcd_glyph_count) || (_lcd_glyph_entries[i].stamp < _lcd_glyph_entries[oldest].stamp))
+				oldest = i;
+		}
+		if (oldest == _lcd_glyph_count)
+			return NULL;	// everything left is pinned
+		_lcd_glyph_cache_remove(oldest);
+	}
+
+	GLYPHENTRY *entry = &(_lcd_glyph_entries[_lcd_glyph_count++]);
+	entry->key = key;
+	entry->scale = scale;
+	entry->offset = _lcd_glyph_used;
+	entry->length = length;
+	entry->stamp = _lcd_glyph_cache_stamp();
+	_lcd_glyph_used += length;
+
+	return &(_lcd_glyph_pool[entry->offset]);
+}
+#endif
+
+/* ---
+#### void lcdGlyphCacheFlush()
+
+Discard all cached glyphs. This happens automatically when a font slot is changed with `lcdFontConfig()` or `lcdFontClone()`.
+--- */
+void lcdGlyphCacheFlush() {
+#ifdef __SRXE_LCDDEFER_
+	// deferred text must be drawn with the font it was recorded with
+	lcdFlush();
+#endif
+#if LCD_GLYPH_CACHE_SIZE
+	_lcd_glyph_count = 0;
+	_lcd_glyph_used = 0;
+	_lcd_glyph_stamp = 0;
+#endif
+}
+
+/* ---
+#### uint32_t lcdGlyphCacheHits()
+
+Return the number of characters drawn directly from the glyph cache.
+--- */
+uint32_t lcdGlyphCacheHits() {
+	return _lcd_glyph_hits;
+}
+
+/* ---
+#### uint32_t lcdGlyphCacheMisses()
+
+Return the number of characters which had to be converted from the font data.
+
+_Use the hits and misses along with `lcdGlyphCacheUsed()` to choose a `LCD_GLYPH_CACHE_SIZE` for an application._
+--- */
+uint32_t lcdGlyphCacheMisses() {
+	return _lcd_glyph_misses;
+}
+
+/* ---
+#### uint16_t lcdGlyphCacheUsed()
+
+Return the number of bytes of the glyph cache currently holding glyphs.
+--- */
+uint16_t lcdGlyphCacheUsed() {
+#if LCD_GLYPH_CACHE_SIZE
+	return _lcd_glyph_used;
+#else
+	return 0;
+#endif
+}
+
+/* ---
+#### void lcdGlyphCacheStatsReset()
+
+Reset the hit and miss counters.
+--- */
+void lcdGlyphCacheStatsReset() {
+	_lcd_glyph_hits = 0;
+	_lcd_glyph_misses = 0;
+}
+
+
 /* ---
 #### void lcdFontConfig(...)
 
@@ -47,11 +226,13 @@ The input parameters are:
 - uint8_t height - defined in the font `.h` file
 - uint8_t width_bytes - defined in the font `.h` file
 - uint8_t char_bytes - defined in the font `.h` file
-- uint8_t scale - `FONT_DEFAULT_SCALE`, `FONT_DOUBLE_WIDTH`, `FONT_DOUBLE_HEIGHT`, or `FONT_DOUBLED`
+- uint8_t scale - `FONT_DEFAULT_SCALE`, `FONT_DOUBLE_WIDTH`, `FONT_DOUBLE_HEIGHT`, `FONT_DOUBLED`, `FONT_TRIPLED`, `FONT_QUADRUPLED`, or `FONT_SCALE(w, h)` for any 1X thru 4X width and height
+  or the `FONT_<name>_FLAGS` value from a native font `.h` file
 
 **Notes:
 Font dimension parameters are in real pixels, not display triplets.
 Vertical dimensions are always in real pixels.
+Native fonts ignore the scale multipliers.
 --- */
 void lcdFontConfig(uint8_t id, const unsigned char* data, uint8_t width, uint8_t height, uint8_t width_bytes, uint8_t char_bytes, uint8_t scale) {
 	// initialize a font
@@ -63,7 +244,9 @@ void lcdFontConfig(uint8_t id, const unsigned char* data, uint8_t width, uint8_t
 	_srxe_fonts[id].height = height;
 	_srxe_fonts[id].widthbytes = width_bytes;
 	_srxe_fonts[id].charbytes = char_bytes;
-	_srxe_fonts[id].scale = scale;
+	_srxe_fonts[id].scale = (scale & FONT_NATIVE) ? (scale & ~FONT_SCALE_MASK) : scale;
+
+	lcdGlyphCacheFlush();
 }
 
 /* ---
@@ -72,6 +255,7 @@ void lcdFontConfig(uint8_t id, const unsigned char* data, uint8_t width, uint8_t
 One font may use an existing font to save data.
 This is referred to as font cloning.
 The only difference between the two fonts will be any scaling.
+A clone keeps the format flags of its source so a clone of a native font is also native (and drawn at 1X).
 
 This function initializes one of the four slots using the data of another slot.
 
@@ -82,7 +266,7 @@ with `FONT3` being a clone of `FONT1` and `FONT4` being a clone of `FONT2`.
 The input parameters are:
 - uint8_t target_ID - one of `FONT1`, `FONT2`, `FONT3`, or `FONT4` which will share configuration from another font
 - uint8_t source_ID - one of `FONT1`, `FONT2`, `FONT3`, or `FONT4` which provides the source configuration
-- uint8_t scale - `FONT_DEFAULT_SCALE`, `FONT_DOUBLE_WIDTH`, `FONT_DOUBLE_HEIGHT`, or `FONT_DOUBLED` forthe new font
+- uint8_t scale - `FONT_DEFAULT_SCALE`, `FONT_DOUBLE_WIDTH`, `FONT_DOUBLE_HEIGHT`, `FONT_DOUBLED`, `FONT_TRIPLED`, `FONT_QUADRUPLED`, or `FONT_SCALE(w, h)` for the new font
 --- */
 
 void lcdFontClone(uint8_t target_id, uint8_t source_id, uint8_t scale) {
@@ -91,7 +275,12 @@ void lcdFontClone(uint8_t target_id, uint8_t source_id, uint8_t scale) {
 		return;
 
 	memcpy((void*)&(_srxe_fonts[target_id]), (void*)&(_srxe_fonts[source_id]), sizeof(FONTOBJECT));
-	_srxe_fonts[target_id].scale = scale;
+	if (_srxe_fonts[source_id].scale & FONT_NATIVE)
+		_srxe_fonts[target_id].scale = _srxe_fonts[source_id].scale;
+	else
+		_srxe_fonts[target_id].scale = scale & FONT_SCALE_MASK;
+
+	lcdGlyphCacheFlush();
 }
 
 /* ---
@@ -135,7 +324,7 @@ Get the width of a character from the active font.
 **Note:** width is in display triplets, not real pixels._
 --- */
 uint8_t lcdFontWidthGet() {
-	uint8_t w = _srxe_fonts[_srxe_active_font_num].width * (_srxe_fonts[_srxe_active_font_num].scale & FONT_DOUBLE_WIDTH ? 2 : 1);
+	uint8_t w = _srxe_fonts[_srxe_active_font_num].width * FONT_SCALE_WIDTH(_srxe_fonts[_srxe_active_font_num].scale);
 	return TRIPLET_FROM_ACTUAL(TRIPLET_CEILING(w));
 }
 
@@ -147,7 +336,7 @@ Get the height of a character from the active font.
 **Note:** vertical dimensions are always in real pixels._
 --- */
 uint8_t lcdFontHeightGet() {
-	return _srxe_fonts[_srxe_active_font_num].height * (_srxe_fonts[_srxe_active_font_num].scale & FONT_DOUBLE_HEIGHT ? 2 : 1);
+	return _srxe_fonts[_srxe_active_font_num].height * FONT_SCALE_HEIGHT(_srxe_fonts[_srxe_active_font_num].scale);
 }
 
 /* ---
@@ -165,6 +354,130 @@ uint16_t lcdTextWidthGet(const char *text) {
 
 
 
+// --------------------------------------------------------------------------------------------
+// Glyph conversion kernel
+//
+// The font is 1-bit per pixel aka 8 pixels per byte and the LCD screen is 3 pixels per byte (3bits-3bits-2bits) - the code calls this a 'triplet'.
+// Rather than building each triplet one pixel at a time, the kernel uses two lookup tables:
+//  - the scale table expands 2 font pixels into 2..8 screen pixels for a 1X..4X width multiplier
+//  - the triplet table turns 3 screen pixels (fg/bg bits) directly into a triplet byte for a fg/bg color pair
+// The expanded pixels are collected in a small accumulator and drained 3 bits at a time.
+// Height multipliers simply repeat the finished row.
+
+// one triplet from 3 pixel bits; bit0 is the left most pixel
+#define _LCD_TRIPLET(fg, bg, b)		LCD_CORRECT_COLOR((uint8_t)(((((b) & 1) ? (fg) : (bg)) << 6) | ((((b) & 2) ? (fg) : (bg)) << 3) | (((b) & 4) ? (fg) : (bg))))
+#define _LCD_TRIPLET_ROW(fg, bg)	{ _LCD_TRIPLET(fg, bg, 0), _LCD_TRIPLET(fg, bg, 1), _LCD_TRIPLET(fg, bg, 2), _LCD_TRIPLET(fg, bg, 3), \
+									  _LCD_TRIPLET(fg, bg, 4), _LCD_TRIPLET(fg, bg, 5), _LCD_TRIPLET(fg, bg, 6), _LCD_TRIPLET(fg, bg, 7) }
+
+// indexed by ((fg << 2) | bg) and then by the 3 pixel bits
+const uint8_t _lcd_triplet_lut[16][8] PROGMEM = {
+	_LCD_TRIPLET_ROW(0, 0), _LCD_TRIPLET_ROW(0, 1), _LCD_TRIPLET_ROW(0, 2), _LCD_TRIPLET_ROW(0, 3),
+	_LCD_TRIPLET_ROW(1, 0), _LCD_TRIPLET_ROW(1, 1), _LCD_TRIPLET_ROW(1, 2), _LCD_TRIPLET_ROW(1, 3),
+	_LCD_TRIPLET_ROW(2, 0), _LCD_TRIPLET_ROW(2, 1), _LCD_TRIPLET_ROW(2, 2), _LCD_TRIPLET_ROW(2, 3),
+	_LCD_TRIPLET_ROW(3, 0), _LCD_TRIPLET_ROW(3, 1), _LCD_TRIPLET_ROW(3, 2), _LCD_TRIPLET_ROW(3, 3)
+};
+
+// 2 font pixels repeated 'm' times each; bit0 is the left most pixel
+#define _LCD_SCALE_BITS(m, b)		((uint8_t)((((b) & 1) ? ((1 << (m)) - 1) : 0) | (((b) & 2) ? (((1 << (m)) - 1) << (m)) : 0)))
+#define _LCD_SCALE_ROW(m)			{ _LCD_SCALE_BITS(m, 0), _LCD_SCALE_BITS(m, 1), _LCD_SCALE_BITS(m, 2), _LCD_SCALE_BITS(m, 3) }
+
+// indexed by (width multiplier - 1) and then by the 2 pixel bits
+const uint8_t _lcd_scale_lut[4][4] PROGMEM = {
+	_LCD_SCALE_ROW(1), _LCD_SCALE_ROW(2), _LCD_SCALE_ROW(3), _LCD_SCALE_ROW(4)
+};
+
+// convert one row of font pixels to triplets; returns the position after the last triplet written
+static uint8_t *_lcd_glyph_row(const uint8_t *font_row, uint8_t font_width, uint8_t multiplier, uint8_t padding, const uint8_t *triplets, const uint8_t *scale, uint8_t *bp) {
+	uint16_t pixels = 0;			// expanded pixel bits waiting to become triplets
+	uint8_t count = 0;				// number of waiting pixel bits
+	uint8_t cb = 0;					// current font byte
+
+	// NOTE: padding will be 0, 1, or 2; if it is 2, then we split the padding before and after the glyph
+	if (padding == 2)
+		count = 1;					// a background pixel is simply a zero bit
+
+	for (uint8_t k = 0; k < font_width; k += 2) {
+		if (!(k & 0x7))
+			cb = *font_row++;
+
+		uint8_t pair = cb & 0x3;
+		uint8_t bits = multiplier << 1;
+		if ((font_width - k) == 1) {
+			pair &= 0x1;			// odd width; only one pixel remains
+			bits = multiplier;
+		}
+		cb >>= 2;
+
+		pixels |= (uint16_t)scale[pair] << count;
+		count += bits;
+
+		while (count >= TRIPLET_SIZE) {
+			*bp++ = triplets[pixels & 0x7];
+			pixels >>= TRIPLET_SIZE;
+			count -= TRIPLET_SIZE;
+		}
+	}
+
+	// any remaining pixels are padded out with background
+	if (count)
+		*bp++ = triplets[pixels & 0x7];
+
+	return bp;
+}
+
+// convert one character of the font to LCD triplets; returns false if the glyph does not fit in the bitmap
+static bool _lcd_glyph_render(FONTOBJECT *font, char c, uint8_t fg, uint8_t bg, uint8_t *lcd_bitmap, uint16_t lcd_bitmap_size) {
+	uint8_t multiplier_width = FONT_SCALE_WIDTH(font->scale);
+	uint8_t multiplier_height = FONT_SCALE_HEIGHT(font->scale);
+	uint8_t glyph_width = font->width * multiplier_width;
+	uint8_t padding = TRIPLET_OFFSET(glyph_width);	// this is the number of pixels to get to the next triplet boundary
+	uint8_t row_bytes = TRIPLET_FROM_ACTUAL(glyph_width + padding);
+
+	if (((uint16_t)row_bytes * font->height * multiplier_height) > lcd_bitmap_size)
+		return false;
+
+	// the font data character set is SPACE thru tilde; anything else is drawn as a SPACE
+	if ((c < ' ') || (c > '~'))
+		c = ' ';
+
+	uint8_t triplets[8], scale[4];
+	memcpy_P(triplets, _lcd_triplet_lut[(fg << 2) | bg], sizeof(triplets));
+
+	if (font->scale & FONT_NATIVE) {
+		// native data was packed as LCD_BLACK on LCD_WHITE so each pixel is either fully on or fully off
+		memcpy_P(lcd_bitmap, &(font->data[(c - 32) * (font->charbytes)]), font->charbytes);
+		if (!(font->scale & FONT_GREYSCALE)) {
+			for (uint8_t i = 0; i < font->charbytes; i++) {
+				uint8_t b = lcd_bitmap[i];
+				lcd_bitmap[i] = triplets[((b >> 6) & 0x1) | ((b >> 2) & 0x2) | ((b << 2) & 0x4)];
+			}
+		}
+		return true;
+	}
+
+	memcpy_P(scale, _lcd_scale_lut[multiplier_width - 1], sizeof(scale));
+
+	// the font data character set starts at char(32) so we subtract that value from the byte code
+	uint8_t font_bytes[font->charbytes];
+	memcpy_P(font_bytes, &(font->data[(c - 32) * (font->charbytes)]), font->charbytes);
+
+	uint8_t *bp = lcd_bitmap;
+	uint8_t *cp = font_bytes;
+
+	for (uint8_t j = 0; j < font->height; j++) {
+		uint8_t *row = bp;
+		bp = _lcd_glyph_row(cp, font->width, multiplier_width, padding, triplets, scale, bp);
+		for (uint8_t m = 1; m < multiplier_height; m++) {
+			memcpy(bp, row, row_bytes);
+			bp += row_bytes;
+		}
+		cp += font->widthbytes;
+	}
+
+	return true;
+}
+
+
 /* ---
 #### int lcdPutChar(char c)
 
@@ -175,7 +488,107 @@ Return -1 if the character was not displayed, otherwise it returns the width of
 Use `lcdPositionSet()`, `lcdFontSet()`, and `lcdColorSet()` as necessary, prior to using the function.
 
 The current position is updated by this function.
+
+**Note:** Converted characters are kept in the glyph cache. Drawing the same character again with the same font and colors
+sends the cached triplets without any conversion.
+Native fonts are sent directly from PROGMEM when drawn as `LCD_BLACK` on `LCD_WHITE` (greyscale native fonts always are).
 --- */
+// the colors are used as table indexes so they are limited to 2 bits
+static inline uint8_t _lcd_text_fg() {
+	return lcdColorTripletGetF() & 0x3;
+}
+
+static inline uint8_t _lcd_text_bg() {
+	return lcdColorTripletGetB() & 0x3;
+}
+
+// a native font drawn in the colors it was packed with is streamed straight from PROGMEM
+static inline bool _lcd_font_is_direct(FONTOBJECT *font, uint8_t fg, uint8_t bg) {
+	return (font->scale & FONT_NATIVE) && ((font->scale & FONT_GREYSCALE) || ((fg == LCD_BLACK) && (bg == LCD_WHITE)));
+}
+
+// characters outside ' ' .. '~' are drawn as a space, so they are cached as one
+static inline char _lcd_glyph_char(char c) {
+	return ((c < ' ') || (c > '~')) ? ' ' : c;
+}
+
+#if LCD_GLYPH_CACHE_SIZE
+// return the converted glyph from the cache, converting it first if needed; returns NULL if it can not be cached
+static uint8_t *_lcd_glyph_get(FONTOBJECT *font, char c, uint8_t fg, uint8_t bg, uint16_t lcd_bitmap_size) {
+	c = _lcd_glyph_char(c);
+	uint16_t key = _LCD_GLYPH_KEY(_srxe_active_font_num, fg, bg, c);
+
+	uint8_t *lcd_bitmap = _lcd_glyph_cache_find(key, font->scale);
+	if (lcd_bitmap) {
+		_lcd_glyph_hits++;
+		return lcd_bitmap;
+	}
+
+	_lcd_glyph_misses++;
+	lcd_bitmap = _lcd_glyph_cache_alloc(key, font->scale, lcd_bitmap_size);
+	if (lcd_bitmap && !_lcd_glyph_render(font, c, fg, bg, lcd_bitmap, lcd_bitmap_size)) {
+		// the entry we just added is always the newest one
+		_lcd_glyph_cache_remove(_lcd_glyph_count - 1);
+		return NULL;
+	}
+	return lcd_bitmap;
+}
+#endif
+
+#ifdef __SRXE_LCDDEFER_
+static int _lcd_put_string(const char *message, uint16_t len);
+
+// the font and colors of deferred text are packed into 'a', the number of characters is 'b', and the characters are in the pool
+#define _LCD_DEFER_TEXT_STYLE()	(_srxe_active_font_num | (_lcd_color_fg << 4) | (_lcd_color_bg << 6))
+
+static void _lcd_defer_draw_text(LCDOP *op) {
+	uint8_t font_num = _srxe_active_font_num;
+	uint8_t fg = _lcd_color_fg;
+	uint8_t bg = _lcd_color_bg;
+	int x = lcdPositionGetX();
+	int y = lcdPositionGetY();
+
+	_srxe_active_font_num = op->a & 0x0F;
+	lcdColorSet((op->a >> 4) & 0x03, op->a >> 6);
+	lcdPositionSet(op->x, op->y);
+	_lcd_put_string((const char *)op->data, op->b);
+
+	_srxe_active_font_num = font_num;
+	lcdColorSet(fg, bg);
+	lcdPositionSet(x, y);
+}
+
+// record text; text which continues the previous text on the same line, in the same font and colors, joins it
+static bool _lcd_defer_text(const char *message, uint8_t len, uint8_t x, uint8_t y, uint8_t cx, uint8_t cy) {
+	uint8_t style = _LCD_DEFER_TEXT_STYLE();
+	uint8_t *p;
+
+	_lcd_defer_cull(x, y, cx, cy);
+
+	LCDOP *op = _lcd_defer_last(_lcd_defer_draw_text);
+	if (op && (op->a == style) && (op->y == y) && (op->cy == cy) && ((op->x + op->cx) == x)
+		&& (((const uint8_t *)op->data + op->b) == &(_lcd_defer_pool[_lcd_defer_pool_used])) && ((op->b + len) <= 255)
+		&& (p = _lcd_defer_pool_alloc(len))) {
+		memcpy(p, message, len);
+		op->b += len;
+		op->cx += cx;
+		_lcd_defer_recorded += (cx * cy) + LCD_WINDOW_COST;
+		return true;
+	}
+
+	if (!_lcd_defer_room(len))
+		return false;
+	p = _lcd_defer_pool_alloc(len);
+	memcpy(p, message, len);
+
+	op = _lcd_defer_add(_lcd_defer_draw_text, x, y, cx, cy, (cx * cy) + LCD_WINDOW_COST);
+	op->a = style;
+	op->b = len;
+	op->data = p;
+	return true;
+}
+#endif
+
 int lcdPutChar(char c) {
 	// The initial location, font, and color(s) must already be set before using this function
 	// eg: lcdPositionSet(x, y); lcdColorSet(fg, bg); lcdFontSet(id);
@@ -183,148 +596,173 @@ int lcdPutChar(char c) {
 	int x = lcdPositionGetX();
 	int y = lcdPositionGetY();
 
-	uint8_t fg = lcdColorTripletGetF() & 0x3;
-	uint8_t bg = lcdColorTripletGetB() & 0x3;
-
-	if (fg > 3) fg = 3;
-	if (bg > 3) bg = 3;
+	uint8_t fg = _lcd_text_fg();
+	uint8_t bg = _lcd_text_bg();
 
 	FONTOBJECT *font = _lcd_font_get_pointer();
 
-	uint8_t font_width = font->width;
-	uint8_t font_multiplier_width = ((font->scale & FONT_DOUBLE_WIDTH) ? 2 : 1);
-	uint8_t glyph_width = font_width * font_multiplier_width;
-	uint8_t font_height = font->height;
-	uint8_t font_multiplier_height = ((font->scale & FONT_DOUBLE_HEIGHT) ? 2 : 1);
-	uint8_t glyph_height = font_height * font_multiplier_height;
-	uint8_t font_widthbytes = font->widthbytes;
-	uint8_t font_charbytes = font->charbytes;
-
-	// NOTE: padding will be 0, 1, or 2; if it is 2, then we split the padding before and after the glyph
-	uint8_t padding = TRIPLET_OFFSET(glyph_width);	// this is the number of pixels to get to the next triplet boundary
+	uint8_t glyph_width = font->width * FONT_SCALE_WIDTH(font->scale);
+	uint8_t glyph_height = font->height * FONT_SCALE_HEIGHT(font->scale);
+	uint8_t padding = TRIPLET_OFFSET(glyph_width);
 
 	// if the character will not fit, then we error out
 	if ((glyph_width + TRIPLET_TO_ACTUAL(x)) > LCD_WIDTH_ACTUAL)
 		return -1;
 
-	// NOTE:    font data is width (bits) first by height (bits)
-	//          the pixel bits are stored mirrored (the low bit is the left most pixel)
-	// WARNING: font width must be a multiple of 3 ... well, actually we pad the end with background color
+#ifdef __SRXE_LCDDEFER_
+	if (_lcd_defer_fits(x, y, TRIPLET_FROM_ACTUAL(glyph_width + padding), glyph_height)
+		&& _lcd_defer_text(&c, 1, x, y, TRIPLET_FROM_ACTUAL(glyph_width + padding), glyph_height)) {
+		x += TRIPLET_FROM_ACTUAL(glyph_width + padding);
+		lcdPositionSet(x, y);
+		return x;
+	}
+#endif
 
-	// the code used a LCD bitmap buffer and pointer (bp), as well as a character bitmap buffer and pointer (cp)
-	// the font is 1-bit per pixel aka 8 pixels per byte and the LCD screen is 3 pixels per byte (3bits-3bits-2bits) - the code calls this a 'triplet'
+	uint16_t lcd_bitmap_size = TRIPLET_FROM_ACTUAL(glyph_width + padding) * glyph_height;
+	uint8_t *lcd_bitmap = NULL;
+
+	if (_lcd_font_is_direct(font, fg, bg)) {
+		if ((c < ' ') || (c > '~'))
+			c = ' ';
+		_lcd_set_active_area(x, y, TRIPLET_FROM_ACTUAL(glyph_width + padding), glyph_height);
+		_lcd_write_data_block_P(&(font->data[(c - 32) * (font->charbytes)]), lcd_bitmap_size);
+		_lcd_end_active_area();
+
+		x += TRIPLET_FROM_ACTUAL(glyph_width + padding);
+		lcdPositionSet(x, y);
+		return x;
+	}
 
-	// BUG there is some problem with FONT4
+#if LCD_GLYPH_CACHE_SIZE
+	lcd_bitmap = _lcd_glyph_get(font, c, fg, bg, lcd_bitmap_size);
+#else
+	_lcd_glyph_misses++;
+#endif
+
+	if (lcd_bitmap) {
+		_lcd_set_active_area(x, y, TRIPLET_FROM_ACTUAL(glyph_width + padding), glyph_height);
+		_lcd_write_data_block(lcd_bitmap, lcd_bitmap_size); // write character pattern
+		_lcd_end_active_area();
+	} else {
+		// the glyph is too large for the cache so it is converted on the stack
+		uint8_t scratch[lcd_bitmap_size];
+		if (!_lcd_glyph_render(font, c, fg, bg, scratch, lcd_bitmap_size))
+			return -1;
+		_lcd_set_active_area(x, y, TRIPLET_FROM_ACTUAL(glyph_width + padding), glyph_height);
+		_lcd_write_data_block(scratch, lcd_bitmap_size); // write character pattern
+		_lcd_end_active_area();
+	}
 
-	uint16_t lcd_bitmap_size = TRIPLET_FROM_ACTUAL(glyph_width + padding) * glyph_height;
-	uint8_t lcd_bitmap[lcd_bitmap_size], *bp, bp_counter;									// lcd bitmap and pointer
-	uint8_t font_bytes[font_charbytes], *cp, cb, cb_multiplier_width, cb_multiplier_height; // font character buffer and pointer and current byte
-	uint8_t triplet;
-	uint8_t pixel; // this is the index of the current pixel; we used to use the 'k' loop variable but now we might already have a pixels before the loop starts
+	// update position
+	x += TRIPLET_FROM_ACTUAL(glyph_width + padding);
+	lcdPositionSet(x, y);
 
-	bp = lcd_bitmap;
-	bp_counter = 0;
-	cb_multiplier_width = cb_multiplier_height = 1;
+	return x;
+}
 
-	// the font data character set starts at char(32) so we subtract that value from the byte code
-	// get pointer to the character's pixel bytes in PROGMEM
-	cp = (unsigned char *)&(font->data[(c - 32) * (font_charbytes)]);
-	memcpy_P(font_bytes, cp, font_charbytes); // then copy from PROGMEM to local buffer
-	cp = font_bytes;						  // then update the pointer to the local buffer
-	cb = cp[0];
-
-	// process each byte of pixels of the character
-	for (int j = 0; j < font_charbytes;) {
-		triplet = bg;
-		pixel = 0;
-
-		if (padding == 2) { // when padding == 2 we put one pixel before and one pixel after
-			// shift the output byte left 3 to make room for the next pixel
-			triplet <<= 3;
-			// clear low 3 bits
-			triplet &= 0b11111000;
-			triplet |= bg;
-			pixel++;
-		}
 
-		// process a single row of the font character bitmap
-		for (int k = 0; k < (font_width * font_multiplier_width); k++) {
-
-			// after every 3 pixels, we need to start the next triplet
-			if (pixel && !(pixel % TRIPLET_SIZE)) {
-				// WTF - try cleaning up the triplet
-				triplet = LCD_CORRECT_COLOR(triplet);
-				*bp = triplet;
-				bp++;
-				triplet = bg;
-				bp_counter++;
-				if (bp_counter >= lcd_bitmap_size) {
-					return -1;
-				}
-			}
+// --------------------------------------------------------------------------------------------
+// String runs
+//
+// Drawing a string one character at a time opens a new LCD window (3 commands and 8 parameter bytes) for every character.
+// A run gathers the glyphs for as many consecutive characters as possible and sends them through a single window,
+// row by row, with the LCD selected for the whole run.
+// The glyphs of a run are held in the glyph cache, so they are pinned while the run is gathered.
+// If the cache can not hold any more of the run, the run ends early and the next run picks up from there.
 
-			// do we need to get the next pixel byte from the input
-			// if its not the (very beginning) and (if either (we have process 8 pixel bits) or (we have reach the end of a row of the font))
-			if (k && !(k % (8 * font_multiplier_width))) {
-				j++;
-				cb = cp[j];
-			}
+static uint32_t _lcd_text_runs, _lcd_text_run_chars;
 
-			// shift the output byte left 3 to make room for the next pixel
-			triplet <<= TRIPLET_SIZE;
-			// clear low 3 bits
-			triplet &= 0b11111000;
-
-			// if the low pixel bit is 1, then we set the low two bits of the bitmap byte to fg
-			triplet |= (cb & 0x1) ? fg : bg;
-			pixel++;
-
-			// if wer are multiplying the width, then we repeat the same pixel
-			if (cb_multiplier_width < font_multiplier_width) {
-				cb_multiplier_width++;	// repeat the same pixel
-			} else {
-				cb_multiplier_width = 1;
-				cb = cb >> 1; 			// discard the used pixel bit
-			}
-		} // end of for loop of one row of pixels pixels from the character bitmap data
-
-		// pad out the end of the triplet
-		if (padding) {
-			// shift the output byte left 3 to make room for the next pixel
-			triplet <<= 3;
-			// clear low 3 bits
-			triplet &= 0b11111000;
-			triplet |= bg;
+// draw as many characters as fit in one window; returns the number of characters drawn, 0 if none fit, or -1 on error
+static int _lcd_put_run(const char *message, uint16_t len) {
+	int x = lcdPositionGetX();
+	int y = lcdPositionGetY();
+
+	uint8_t fg = _lcd_text_fg();
+	uint8_t bg = _lcd_text_bg();
+
+	FONTOBJECT *font = _lcd_font_get_pointer();
+
+	uint8_t glyph_width = font->width * FONT_SCALE_WIDTH(font->scale);
+	uint8_t glyph_height = font->height * FONT_SCALE_HEIGHT(font->scale);
+	uint8_t row_bytes = TRIPLET_FROM_ACTUAL(glyph_width + TRIPLET_OFFSET(glyph_width));
+	uint16_t lcd_bitmap_size = row_bytes * glyph_height;
+
+	// limit the run to the characters which fit on the line
+	if ((glyph_width + TRIPLET_TO_ACTUAL(x)) > LCD_WIDTH_ACTUAL)
+		return 0;
+	uint16_t count = ((LCD_WIDTH - x) / row_bytes);
+	if (count > len)
+		count = len;
+
+#ifdef __SRXE_LCDDEFER_
+	if (_lcd_defer_fits(x, y, count * row_bytes, glyph_height)
+		&& _lcd_defer_text(message, count, x, y, count * row_bytes, glyph_height)) {
+		lcdPositionSet(x + (count * row_bytes), y);
+		return count;
+	}
+#endif
+
+	bool direct = _lcd_font_is_direct(font, fg, bg);
+	const uint8_t *glyphs[count];
+
+	if (direct) {
+		for (uint16_t i = 0; i < count; i++) {
+			glyphs[i] = &(font->data[(_lcd_glyph_char(message[i]) - 32) * (font->charbytes)]);
 		}
-		// WTF - try cleaning up the triplet
-		triplet = LCD_CORRECT_COLOR(triplet);
-		*bp = triplet;
-		bp++;
-		bp_counter++;
-		// throw away any remaining bits and start with a new byte from the source pixels
-		j++;
-
-		if (cb_multiplier_height < font_multiplier_height) {
-			cb_multiplier_height++;
-			j -= font_widthbytes;
-		} else {
-			cb_multiplier_height = 1;
+	} else {
+#if LCD_GLYPH_CACHE_SIZE
+		// first make sure every glyph of the run is in the cache; nothing used from here on may be evicted
+		uint16_t n;
+		_lcd_glyph_pin = _lcd_glyph_stamp + 1;
+		for (n = 0; n < count; n++) {
+			if (!_lcd_glyph_get(font, message[n], fg, bg, lcd_bitmap_size))
+				break;
 		}
+		_lcd_glyph_pin = 0;
 
-		cb = cp[j];
-
-	} // end of for loop of character bitmap data
+		// adding glyphs may have moved others within the pool so only now are the locations collected
+		for (count = 0; count < n; count++) {
+			glyphs[count] = _lcd_glyph_cache_find(_LCD_GLYPH_KEY(_srxe_active_font_num, fg, bg, _lcd_glyph_char(message[count])), font->scale);
+			if (!glyphs[count])
+				break;
+		}
+#else
+		count = 0;
+#endif
+		// a glyph which can not be cached is drawn on its own
+		if (!count)
+			return (lcdPutChar(message[0]) < 0) ? -1 : 1;
+	}
 
-	// assuming we did everything correctly, the bitmap is now loaded up
-	_lcd_set_active_area(x, y, TRIPLET_FROM_ACTUAL(glyph_width + padding), glyph_height);
-	_lcd_write_data_block(lcd_bitmap, lcd_bitmap_size); // write character pattern
+	_lcd_set_active_area(x, y, count * row_bytes, glyph_height);
+	_lcd_write_data_begin();
+	for (uint16_t offset = 0; offset < lcd_bitmap_size; offset += row_bytes) {
+		for (uint16_t i = 0; i < count; i++) {
+			const uint8_t *bp = glyphs[i] + offset;
+			for (uint8_t k = 0; k < row_bytes; k++)
+				_lcd_write_data_byte(direct ? pgm_read_byte(bp + k) : bp[k]);
+		}
+	}
+	_lcd_write_data_end();
 	_lcd_end_active_area();
 
-	// update position
-	x += TRIPLET_FROM_ACTUAL(glyph_width + padding);
-	lcdPositionSet(x, y);
+	_lcd_text_runs++;
+	_lcd_text_run_chars += count;
 
-	return x;
+	lcdPositionSet(x + (count * row_bytes), y);
+	return count;
+}
+
+// draw the first 'len' characters of a string as runs; returns the new X position or -1 if any character did not fit
+static int _lcd_put_string(const char *message, uint16_t len) {
+	while (len) {
+		int n = _lcd_put_run(message, len);
+		if (n <= 0)
+			return -1;
+		message += n;
+		len -= n;
+	}
+	return lcdPositionGetX();
 }
 
 
@@ -338,22 +776,27 @@ Return -1 if the character was not displayed, otherwise it returns the width of
 Use `lcdPositionSet()`, `lcdFontSet()`, and `lcdColorSet()` as necessary, prior to using the function.
 
 The current position is updated by this function.
+
+**Note:** Consecutive characters are sent to the LCD as a single run rather than one character at a time.
 --- */
 int lcdPutString(const char *message) //small font 576 bytes
 {
 	if (!_lcd_init) return -1;
 
-	int w, width = 0;
-	int text_len = strlen(message);
+	return _lcd_put_string(message, strlen(message));
+}
 
-	for (int i = 0; i < text_len; i++) {
-		w = lcdPutChar(message[i]);
-		if (w < 0)
-			break;
-		width += w;
-	}
+/* ---
+#### uint16_t lcdTextRunAverage()
+
+Return the average number of characters sent per LCD window by the string functions, times 10.
+A value of 10 means each character needed its own window.
+--- */
 
-	return w;
+uint16_t lcdTextRunAverage() {
+	if (!_lcd_text_runs)
+		return 0;
+	return (uint16_t)((_lcd_text_run_chars * 10) / _lcd_text_runs);
 }
 
 /* ---
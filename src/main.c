@@ -6,15 +6,21 @@
 
 #define PERIODIC_INTERVAL 3000	// update rate for stats
 #define KEYSCAN_RATE 10 		// milliseconds between keyboard scans
-#define RF_CHANNEL 16 			// 1 .. 16
+#define RF_CHANNEL 16 			// 1 .. 16; the channel everyone starts on; the group only moves when someone asks it to
+#define RF_GROUP 0x5258			// PAN ID of the group; devices only receive frames from their own group
+#define RF_WAKE_INTERVAL 250	// milliseconds between radio wakes; messages take up to this long to arrive
+#define RF_FIND_DWELL 500		// milliseconds to listen for the group on each channel; longer than RF_WAKE_INTERVAL
 #define INPUT_LINES 3
+#define HISTORY_LINES 8			// lines of the saved transcript shown at startup
+#define TRANSCRIPT_FONT FONT1
 
 static bool _redraw_needed = true;
 static unsigned long _update_timer;
 static unsigned long _keyscan_timer;
 
 static char transmit_buffer[RF_TX_BUFFER_SIZE] = "";
-static uint8_t transmit_length = 0;
+static char _outgoing[RF_TX_BUFFER_SIZE];	// the input is cleared while the message is still being sent
+static UIEDITOR _input;
 
 void updateStatusBar() {
 
@@ -35,31 +41,116 @@ void updateStatusBar() {
 
 
 	lcdPositionSet(LCD_WIDTH - 1 - lcdFontWidthGet() * 14, 2);
-	printDevicePrintf(PRINT_LCD, "% 3d/% 3d", transmit_length, RF_TX_BUFFER_SIZE);
+	printDevicePrintf(PRINT_LCD, "% 3d/% 3d", _input.length, RF_TX_BUFFER_SIZE);
+
+	// the portion of time the radio has been awake
+	if (rfInited()) {
+		uint16_t duty = rfLplDutyCycle();
+		lcdPositionSet(LCD_WIDTH - 1 - lcdFontWidthGet() * 23, 2);
+		printDevicePrintf(PRINT_LCD, "RF%3d.%d%%", duty / 100, (duty % 100) / 10);
+		lcdPositionSet(LCD_WIDTH - 1 - lcdFontWidthGet() * 28, 2);
+		printDevicePrintf(PRINT_LCD, "CH%2d", rfInited());
+	}
 
 }
 
 void updateInputBox() {
+	lcdColorSet(LCD_BLACK, LCD_WHITE);
+	uiEditorDraw(&_input);
+}
+
+// the transcript fills the space between the status bar and the largest input box
+void initTranscript() {
 	lcdFontSet(FONT2);
+	uint8_t top = lcdFontHeightGet() + 3;
+	uint8_t bottom = ((RF_TX_BUFFER_SIZE - 1) / (LCD_WIDTH / lcdFontWidthGet()) + 1) * lcdFontHeightGet();
+
 	lcdColorSet(LCD_BLACK, LCD_WHITE);
+	uiPaneInit(top, LCD_HEIGHT - top - bottom, TRANSCRIPT_FONT);
+}
+
+// each line of the transcript is also saved to the FLASH log; the first byte of a record marks a line which was sent
+void addLine(char *text, bool sent) {
+	static uint8_t record[FLASH_LOG_RECORD_MAX];
 
-	uint8_t rows, cols, start_y, x, y;
-	cols = LCD_WIDTH / lcdFontWidthGet();
-	rows = transmit_length / cols + 1;
+	lcdColorSet(sent ? LCD_DARK : LCD_BLACK, LCD_WHITE);
+	uiPaneAdd(text);
 
-	start_y = LCD_HEIGHT - lcdFontHeightGet() * rows;
+	uint8_t length = strnlen(text, FLASH_LOG_RECORD_MAX - 1);
+	record[0] = sent;
+	memcpy(record + 1, text, length);
+	flashLogAppend(record, length + 1);
+}
+
+// the last lines saved to the FLASH log start the transcript
+void showHistory() {
+	static uint8_t record[FLASH_LOG_RECORD_MAX + 1];
+	FLASHLOGCURSOR cursor;
+	uint16_t count = flashLogCount();
+	int length;
+
+	if (!count || !flashLogSeek(&cursor, ((count < HISTORY_LINES) ? count : HISTORY_LINES) - 1))
+		return;
+	while ((length = flashLogNext(&cursor, record, FLASH_LOG_RECORD_MAX)) > 0) {
+		record[length] = 0;
+		lcdColorSet(record[0] ? LCD_DARK : LCD_BLACK, LCD_WHITE);
+		uiPaneAdd((char *)(record + 1));
+	}
+}
+
+// a device which was off while the group moved listens for it on every channel
+void findGroup() {
+	if (rfInited())
+		rfChannelFind(RF_FIND_DWELL);
+}
 
-	for (uint8_t i = 0; i < rows * cols; i++) {
-		y = start_y + i / cols * lcdFontHeightGet();
-		x = i % cols * lcdFontWidthGet();
-		if (i < transmit_length) {
-			lcdPositionSet(x, y);
-			lcdPutChar(transmit_buffer[i]);
-		} else {
-			lcdRectangle(x, y, lcdFontWidthGet(), lcdFontHeightGet(), LCD_ERASE);
+// the group moves to the quietest channel; only the device whose user asked announces it
+void moveGroup() {
+	if (!rfInited())
+		return;
+	// another device may already be moving the group; its announcement is followed instead
+	uint32_t started = clockMillis();
+	while ((clockMillis() - started) < RF_FIND_DWELL) {
+		uint8_t channel = rfChannelAnnounced();
+		if (channel) {
+			rfChannelSet(channel);
+			return;
 		}
+		rfLplPoll();
 	}
+	rfChannelAnnounce(rfChannelSurvey());	// low power listening is on, so sleeping devices hear it
+}
 
+void handleRadio() {
+	RFFRAME *frame;
+	RFMSG *msg;
+	RFMESHFRAME *mesh;
+
+	if (!rfInited())
+		return;
+
+	// another device found a quieter channel
+	uint8_t channel = rfChannelAnnounced();
+	if (channel)
+		rfChannelSet(channel);
+
+	rfMsgPoll();
+	rfMeshPoll();
+	rfLplPoll();
+
+	// each frame or message is one line of the transcript; the data is null terminated in place
+	while ((mesh = rfMeshReceive())) {
+		addLine((char *)mesh->data, false);
+		rfMeshRelease();
+	}
+	while ((msg = rfMsgReceive())) {
+		addLine((char *)msg->data, false);
+		rfMsgRelease(msg);
+	}
+	while ((frame = rfReceiveFrame())) {
+		addLine((char *)frame->data, false);
+		rfReleaseFrame();
+	}
 }
 
 void updateDisplay() {
@@ -75,6 +166,7 @@ void handlePowerButton() {
 
 		// Turn off
 		if (rfInited()) rfTerm();
+		flashJobFinish();
 		uint8_t lcdContrast = lcdContrastGet();
 		lcdSleep();
 		powerSleep();
@@ -83,13 +175,21 @@ void handlePowerButton() {
 		// Woken up
 		lcdColorSet(LCD_BLACK, LCD_WHITE);
 		lcdClearScreen();
+		uiPaneClear();	// the offset scrolled to before sleeping no longer matches the screen
+		showHistory();
 		lcdWake();
 		lcdContrastSet(lcdContrast);
 		rfInit(RF_CHANNEL);
+		rfMsgInit();
+		rfMeshInit();
+		rfAddressSet(RF_GROUP, rfAddressDefault());
+		rfLplSet(RF_WAKE_INTERVAL);
 
 		_update_timer = clockMillis();
 		_keyscan_timer = _update_timer;
 		updateDisplay();
+		uiEditorRedraw(&_input);
+		updateInputBox();
 
 	}
 }
@@ -111,21 +211,38 @@ void handleKeys() {
 			case KEY_LEFT:
 				lcdContrastReset();
 				break;
-			case KEY_RIGHT:
+			case KEY_MENU1:
+				findGroup();
+				break;
+			case KEY_MENU2:
+				moveGroup();
+				break;
 			case KEY_ENTER:
-				memset(transmit_buffer, 0, sizeof(transmit_buffer));
-				transmit_length = 0;
+				// a long line stays in the editor until the last one has been sent
+				if (rfInited() && (_input.length > RF_MESH_PAYLOAD_SIZE) && rfMsgSending())
+					break;
+				if (_input.length) {
+					addLine(transmit_buffer, true);
+					if (rfInited()) {
+						// short lines are relayed across the mesh; longer ones only reach nearby devices
+						if (_input.length <= RF_MESH_PAYLOAD_SIZE) {
+							rfMeshSend((uint8_t *)transmit_buffer, _input.length, 0);
+						} else {
+							strcpy(_outgoing, transmit_buffer);
+							rfMsgSend(RF_BROADCAST, (uint8_t *)_outgoing, _input.length);
+						}
+					}
+				}
+				// fall through
+			case KEY_RIGHT:
+				uiEditorClear(&_input);
 				break;
 			case KEY_DEL:
-				if (transmit_length) {
-					transmit_buffer[--transmit_length] = 0;
-				}
+				uiEditorDelete(&_input);
 				break;
 			default:
 				if (key < 0x20 || key > 0x7e) break;
-				if (transmit_length < sizeof(transmit_buffer) - 1) {
-					transmit_buffer[transmit_length++] = key;
-				}
+				uiEditorInsert(&_input, key);
 				break;
 		}
 		updateInputBox();
@@ -135,7 +252,11 @@ void handleKeys() {
 void loop() {
 	handlePowerButton();
 	updateDisplay();
+	handleRadio();
 	handleKeys();
+	flashJobPoll();	// the FLASH chip erases and writes while the loop keeps turning
+	flashLogPoll();	// erase the spare sector of the FLASH log, when it is needed
+	lcdFlush();		// draw everything from this pass through the loop in one go
 }
 
 int main() {
@@ -143,8 +264,17 @@ int main() {
 	powerInit();
 	//rfInit(RF_CHANNEL);
 	//randomInit(); // (must be after RF)
+	rfChannelInit();
+	eepromInit();
+	flashInit();
+	flashLogInit();
 	kbdInit();
 	lcdInit();
+	lcdDeferBegin();
+	uiEditorInit(&_input, transmit_buffer, sizeof(transmit_buffer), 0, LCD_HEIGHT, LCD_WIDTH, FONT2);
+	initTranscript();
+	showHistory();
+	updateInputBox();
 
 	_update_timer = clockMillis();
 	_keyscan_timer = _update_timer;
@@ -83,6 +83,24 @@ typedef enum {
 #define PRINT_MAX PRINT_UART
 static uint8_t _print_device;
 
+#ifdef __SRXE_LCDTEXT_
+// LCD output is collected and drawn as a run rather than one character at a time
+#ifndef PRINT_LCD_RUN_SIZE
+#define PRINT_LCD_RUN_SIZE 48
+#endif
+static char _print_lcd_run[PRINT_LCD_RUN_SIZE];
+static uint8_t _print_lcd_run_len;
+
+static void _print_lcd_flush() {
+	if (_print_lcd_run_len) {
+		_lcd_put_string(_print_lcd_run, _print_lcd_run_len);
+		_print_lcd_run_len = 0;
+	}
+}
+#else
+#define _print_lcd_flush()
+#endif
+
 /**
  * Output a character to the pre set target device
  */
@@ -90,8 +108,11 @@ void _putchar(char c) {
 	switch (_print_device) {
 #ifdef __SRXE_LCDTEXT_
 		case PRINT_LCD: {
-			if (c)
-				lcdPutChar(c);
+			if (c) {
+				_print_lcd_run[_print_lcd_run_len++] = c;
+				if (_print_lcd_run_len >= PRINT_LCD_RUN_SIZE)
+					_print_lcd_flush();
+			}
 		} break;
 #endif
 #ifdef __SRXE_RF_
@@ -1006,6 +1027,7 @@ int printf_(const char *format, ...) {
 	char buffer[1];
 	const int ret = _vsnprintf(_out_char, buffer, (size_t)-1, format, va);
 	va_end(va);
+	_print_lcd_flush();
 	return ret;
 }
 
@@ -1027,7 +1049,9 @@ int snprintf_(char *buffer, size_t count, const char *format, ...) {
 
 int vprintf_(const char *format, va_list va) {
 	char buffer[1];
-	return _vsnprintf(_out_char, buffer, (size_t)-1, format, va);
+	const int ret = _vsnprintf(_out_char, buffer, (size_t)-1, format, va);
+	_print_lcd_flush();
+	return ret;
 }
 
 int vsnprintf_(char *buffer, size_t count, const char *format, va_list va) {
@@ -1054,6 +1078,7 @@ If a device is not available, no output will occur.
 --- */
 
 void printDeviceSet(uint8_t device) {
+	_print_lcd_flush();
 	if (device <= PRINT_MAX)
 		_print_device = device;
 }
@@ -1064,6 +1089,7 @@ void printDeviceSet(uint8_t device) {
 replacement for stdlib printf() function with the output going to the specified device.
 
 When used for output to LCD, this function will used the current LCD position, font, and colors. Do not use any newline or linefeed characters with the LCD.
+The LCD output is drawn as runs of characters, the same as `lcdPutString()`.
 
 When used for output to the UART, linefeed and newline are not automatically added and must be part of the `fmt` string as appropriate.
 
@@ -49,6 +49,24 @@ They are:
 #define RF_CHANNEL_MIN 1
 #define RF_CHANNEL_MAX 16
 
+/* ---
+Besides the IEEE 802.15.4 rate of 250kb/s, the transceiver has proprietary rates of up to 2Mb/s.
+Higher rates send each frame in less time, so bulk transfers finish sooner and the radio spends less time transmitting,
+but the receiver is less sensitive so the range is shorter. Every device in a group must use the same rate.
+The rate used by `rfInit()` is set at compile time, and may be changed with `rfDataRateSet()`:
+```C
+*/
+#define RF_RATE_250K	0		// IEEE 802.15.4; receiver sensitivity -100dBm
+#define RF_RATE_500K	1		// -96dBm
+#define RF_RATE_1M		2		// -94dBm
+#define RF_RATE_2M		3		// -86dBm
+#ifndef RF_DATA_RATE
+#define RF_DATA_RATE	RF_RATE_250K
+#endif
+/*
+```
+--- */
+
 // the RF code is only for the ATMEGA128RFA1 chip
 #ifndef CHIP_ATMEGA128RFA1
 #define CHIP_ATMEGA128RFA1
@@ -151,15 +169,186 @@ They are:
 #define HW_FRAME_TX_SIZE		127							// TX uses a byte for the length
 
 
-#define RF_TX_BUFFER_SIZE (HW_FRAME_TX_SIZE+1)				// could be larger but the current code does not need it
-#define RF_RX_BUFFER_SIZE (HW_FRAME_RX_SIZE * 2)			// it only needs to be larger than HW_FRAME_BUFFER_SIZE to allow for more than a single message to arrive before being read
+#define RF_TX_BUFFER_SIZE (HW_FRAME_TX_SIZE+1)				// could be larger but the current code does not need it; must be a power of 2, up to 128
 
-static uint8_t rfRxData[RF_RX_BUFFER_SIZE];
 static uint8_t rfTxData[RF_TX_BUFFER_SIZE];
 
+/* ---
+Received frames are kept whole in a ring of frame slots. The receive interrupt copies each frame once,
+straight from the transceiver frame buffer into the next free slot, along with its signal strength and link quality.
+When every slot is full, new frames are dropped and counted by `rfReceiveBufferOverflow()`.
+
+The number of slots is set at compile time:
+```C
+*/
+#ifndef RF_RX_FRAMES
+#define RF_RX_FRAMES	4		// received frames held until they are read; must be a power of 2
+#endif
+/*
+```
+
+Each slot is an `RFFRAME`:
+```C
+*/
+#define RF_FRAME_DATA_SIZE	(HW_FRAME_TX_SIZE - 2)	// a frame is at most 127 bytes including the 2 byte FCS
+
+typedef struct _RFFRAME {
+	uint8_t length;		// number of data bytes; the FCS is not included
+	uint8_t rssi;		// signal strength at the start of the frame; 0..28 in 3dB steps from -90dBm
+	uint8_t lqi;		// link quality indicator; 0..255
+	uint16_t source;	// short address of the sender in extended mode; RF_ADDRESS_NONE otherwise
+	uint8_t data[RF_FRAME_DATA_SIZE + 1];	// the data is always followed by a 0 so text may be used in place
+} RFFRAME;
+/*
+```
+--- */
+
+static RFFRAME _rf_rx_frames[RF_RX_FRAMES];
+static volatile uint8_t _rf_rx_head;	// count of frames stored by the receive interrupt
+static volatile uint8_t _rf_rx_tail;	// count of frames released by the application
+static uint8_t _rf_rx_read;				// bytes of the oldest frame already taken by the byte functions
+
+#define _RF_RX_COUNT()	((uint8_t)(_rf_rx_head - _rf_rx_tail))
+
+/* ---
+Frames to be sent wait in a transmit queue. Sending is driven by the transceiver interrupts, so queuing a frame
+returns immediately and the program keeps running while the frames are sent.
+The radio returns to receiving when the queue is empty.
+
+The size of the queue is set at compile time:
+```C
+*/
+#ifndef RF_TX_FRAMES
+#define RF_TX_FRAMES	4		// frames waiting to be sent; must be a power of 2
+#endif
+/*
+```
+
+The status of a queued frame is one of:
+```C
+*/
+#define RF_TX_SUCCESS		0	// the frame was sent (and acknowledged in extended mode)
+#define RF_TX_PENDING		1	// the frame is waiting to be sent or is being sent
+#define RF_TX_CHANNEL_BUSY	3	// extended mode: the channel was never clear
+#define RF_TX_NO_ACK		5	// extended mode: the frame was not acknowledged after all of the retries
+#define RF_TX_INVALID		7	// extended mode: the transceiver could not send the frame
+#define RF_TX_UNKNOWN		0xFF	// the frame is too old for its status to still be known
+/*
+```
+--- */
+
+typedef struct _RFTXSLOT {
+	uint8_t length;
+	uint8_t data[RF_FRAME_DATA_SIZE];
+} RFTXSLOT;
+
+static RFTXSLOT _rf_tx_frames[RF_TX_FRAMES];
+static uint8_t _rf_tx_status[RF_TX_FRAMES];	// the result of the frame last sent from each slot
+static volatile uint8_t _rf_tx_head;		// count of frames queued by the application
+static volatile uint8_t _rf_tx_tail;		// count of frames finished by the transmit interrupt
+
+// the transmit side of the radio
+#define RF_TX_STATE_IDLE		0	// nothing to send; the radio is receiving
+#define RF_TX_STATE_WAITING		1	// waiting for the radio to reach PLL_ON
+#define RF_TX_STATE_SENDING		2	// a frame is being sent
+static volatile uint8_t _rf_tx_state;
+
+#define _RF_TX_COUNT()	((uint8_t)(_rf_tx_head - _rf_tx_tail))
+#define _RF_TRX_STATUS()	(TRX_STATUS & 0x1F)
+
+/* ---
+In extended mode the transceiver acknowledges addressed frames as they are received,
+and sends each frame with CSMA-CA and retries until it is acknowledged.
+The number of attempts is set at compile time:
+```C
+*/
+#ifndef RF_FRAME_RETRIES
+#define RF_FRAME_RETRIES	3		// retries after the first attempt when a frame is not acknowledged; 0..15
+#endif
+#ifndef RF_CSMA_RETRIES
+#define RF_CSMA_RETRIES		4		// CSMA-CA backoffs when the channel is busy; 0..5
+#endif
+#ifndef RF_FILTER_STATS
+#define RF_FILTER_STATS		0		// 1 counts every frame heard in extended mode, at the cost of an interrupt for each; see rfFramesHeard()
+#endif
+/*
+```
+
+Frames have an IEEE 802.15.4 header with the PAN ID and the short addresses of the receiver and the sender.
+This leaves `RF_FRAME_PAYLOAD_SIZE` (116) bytes for the message.
+```C
+*/
+#define RF_BROADCAST		0xFFFF	// the address of every device; broadcast frames are not acknowledged
+#define RF_ADDRESS_NONE		0xFFFE	// a device without a short address; also the source of frames received in basic mode
+#define RF_MAC_HEADER_SIZE	9		// frame control (2), sequence (1), PAN ID (2), destination (2), source (2)
+#define RF_FRAME_PAYLOAD_SIZE	(RF_FRAME_DATA_SIZE - RF_MAC_HEADER_SIZE)
+/*
+```
+--- */
+
+#define _RF_FCF_DATA		0x8841	// data frame, PAN ID compression, short destination and source addresses
+#define _RF_FCF_ACK_REQUEST	0x0020
+#define _RF_FCF_MASK		0xCC47	// the frame type, PAN ID compression, and addressing mode bits
+
+static uint8_t _rf_data_rate = RF_DATA_RATE;	// kept while the radio is off; rfInit() resets the transceiver
+static bool _rf_extended;					// using RX_AACK_ON and TX_ARET_ON
+static uint16_t _rf_pan_id, _rf_address;
+static uint8_t _rf_tx_sequence;
+static uint16_t _rf_rx_last_source;			// the most recent frame, to drop a retry whose ACK was lost
+static uint8_t _rf_rx_last_sequence;
+static uint16_t _rf_rx_duplicates;
+static uint16_t _rf_rx_heard;				// frames the radio started to receive
+static uint16_t _rf_rx_delivered;			// frames for this device which were given to a handler or stored
+
+// low power listening (rflpl.h): receivers only wake briefly every interval, so each frame is repeated for a whole interval
+static uint16_t _rf_lpl_stretch;			// milliseconds to repeat each frame; 0 when not in use
+static uint32_t _rf_tx_started;				// when the frame being sent was first sent
+static uint16_t _rf_rx_last_fcs;			// the most recent frame in basic mode, to drop the repeats
+static uint32_t _rf_rx_last_time;
+static volatile uint8_t _rf_rx_activity;	// counts the start of every received frame
+static void (*_rf_lpl_wake_hook)();			// wakes the radio if it is asleep, so a waiting frame may be sent
+
+// an optional layer, eg: rfsecure.h, which sends the frames of the byte functions in its own format
+static int (*_rf_tx_frame_hook)(const uint8_t *data, uint8_t length);
+static uint8_t _rf_tx_frame_hook_size;		// the most data the layer sends in one frame
+static bool _rf_rx_secure_only;				// frames which are not from a protocol handler are dropped
+static uint16_t _rf_rx_insecure;
+
+// an optional layer, eg: rfpower.h, which picks the transmit power of each frame and learns from the results; extended mode only
+static uint8_t (*_rf_tx_power_hook)(uint16_t address);					// returns the PHY_TX_PWR level for a frame
+static bool (*_rf_tx_result_hook)(uint16_t address, uint8_t status);	// returns true to send the frame again
+static void (*_rf_rx_link_hook)(uint16_t source, uint8_t rssi, uint8_t lqi);
+
+/* ---
+Higher level protocols, eg: `rfmsg.h`, share the radio with the byte and frame functions.
+A frame whose first byte is a protocol ID - `RF_PROTOCOL_MIN` or more - is given to the handler registered for that ID
+instead of being stored in the receive ring. Text never starts with such a byte.
+```C
+*/
+#define RF_PROTOCOL_MIN		0x80	// protocol IDs are 0x80..0xFF
+#ifndef RF_HANDLERS
+#define RF_HANDLERS			4		// number of protocol handlers which may be registered
+#endif
+/*
+```
+--- */
+
+// a handler is called from the receive interrupt with the data of the frame, starting with the protocol ID;
+// it returns false to have the frame stored in the receive ring as usual
+typedef bool (*RFHANDLER)(const uint8_t *data, uint8_t length, uint16_t source);
+
+static uint8_t _rf_handler_ids[RF_HANDLERS];
+static RFHANDLER _rf_handlers[RF_HANDLERS];
+
+#define _RF_TX_ON()	(_rf_extended ? TX_ARET_ON : PLL_ON)
+#define _RF_RX_ON()	(_rf_extended ? RX_AACK_ON : RX_ON)
+
 #include "cbuffer.h"
+#include "clock.h"
+#include "eeprom.h"
 
 static cBufferObj _rf_obj;
+static cRing _rf_tx_ring;	// the bytes of the byte functions, until they are sent in a frame
 
 //#define IO_DEVICE_RF 0	// this is legacy
 
@@ -170,55 +359,170 @@ static uint8_t _rf_signal; // reusable byte access from the INT vectors
 
 
 
-// RF TX is not handled by an interrupt. We process data synchronously to the frame buffer and then let it do it's thing.
-void RF_LOAD_FRAME() {
-	uint8_t length = 0;
-	int c;
+// load the oldest queued frame into the frame buffer and start sending it; the radio must be in PLL_ON or TX_ARET_ON
+static void _rf_tx_start() {
+	RFTXSLOT *slot = &(_rf_tx_frames[_rf_tx_tail & (RF_TX_FRAMES - 1)]);
 	uint8_t *bp = (uint8_t *)(&TRXFBST + 1);
 
-	while (length < (HW_FRAME_TX_SIZE - 1)) {
-		if ((c = bufferGet(&(_rf_obj.txBuffer))) < 0)
-			break;
-		bp[length++] = c;
-	}
-	bp[length++] = 0;
-
-	// length is the number of bytes we have loaded into the hardware frame buffer
+	if (_rf_tx_power_hook && _rf_extended)
+		PHY_TX_PWR = (PHY_TX_PWR & 0xF0) | _rf_tx_power_hook(slot->data[5] | (slot->data[6] << 8));
+	memcpy(bp, slot->data, slot->length);
+	TRXFBST = slot->length + 2;	// the length includes the 2 byte FCS added by the transceiver
 
-	//_rf_tx_debug = 0 - length; // we do this to be able to track state while debugging
-	//The Transceiver State Control Register -- TRX_STATE controls the states of the radio.
-	// Setting the PLL state to PLL_ON begins the TX.
+	if (_rf_tx_state != RF_TX_STATE_SENDING)
+		_rf_tx_started = clockMillis();
+	_rf_tx_state = RF_TX_STATE_SENDING;
+	TRXPR |= (1 << SLPTR);	   // Setting SLPTR high will start the TX.
+	TRXPR &= ~(1 << SLPTR);	   // Setting SLPTR low will end the TX.
+}
 
-	TRXFBST = 2 + length; // length (byte) +  n bytes of data
+// wait a few microseconds for the radio to reach a state; returns true when it is there
+static bool _rf_wait_status(uint8_t status) {
+	for (uint8_t i = 0; (i < 10) && (_RF_TRX_STATUS() != status); i++)
+		_delay_us(1);
+	return (_RF_TRX_STATUS() == status);
 }
 
-void RF_TX_FRAME() {
-	TRX_STATE = (TRX_STATE & 0xE0) | PLL_ON; // Set to TX start state
-	while (!(TRX_STATUS & PLL_ON))
-		; // Wait for PLL to lock
+#define _RF_TX_IDLE_FRAME	50		// milliseconds; the most a frame takes with CSMA-CA and every retry
 
-	RF_LOAD_FRAME();
+// wait for anything being sent to finish; returns false if the queue is still not empty when it should long since have been
+static bool _rf_tx_idle() {
+	if (_rf_lpl_wake_hook)
+		_rf_lpl_wake_hook();
+	uint16_t limit = RF_TX_FRAMES * (_rf_lpl_stretch + _RF_TX_IDLE_FRAME);
+	for (uint16_t ms = 0; _rf_tx_state != RF_TX_STATE_IDLE; ms++) {
+		if (ms >= limit)
+			return false;
+		_delay_ms(1);
+	}
+	return true;
+}
 
-	// The start of frame buffer - TRXFBST is the first byte of the 128 byte frame. It should contain the length of the transmission.
+// move the radio from PLL_ON to the transmit state; returns false if it has not yet reached PLL_ON
+static bool _rf_tx_ready() {
+	if (_RF_TRX_STATUS() == _RF_TX_ON())
+		return true;
+	if (!_rf_wait_status(PLL_ON))
+		return false;
+	if (!_rf_extended)
+		return true;
+	// the extended states are entered and left through PLL_ON
+	TRX_STATE = (TRX_STATE & 0xE0) | TX_ARET_ON;
+	return _rf_wait_status(TX_ARET_ON);
+}
 
-	TRX_STATE |= CMD_TX_START; // initiate TX
-	TRXPR |= (1 << SLPTR);	   // Setting SLPTR high will start the TX.
-	TRXPR &= ~(1 << SLPTR);	   // Setting SLPTR low will end the TX.
+#define RF_ED_MAX	0x53	// the highest energy detection level; -90dBm + 1dB per step
 
-	_delay_ms(1); // not sure if this needed
+// one energy detection measurement of the current channel; the radio must be receiving
+static uint8_t _rf_ed_measure() {
+	IRQ_STATUS = (1 << CCA_ED_DONE);		// clear the flag from the last measurement
+	PHY_ED_LEVEL = 0;						// any write starts a measurement
+	for (uint8_t i = 0; (i < 20) && !(IRQ_STATUS & (1 << CCA_ED_DONE)); i++)
+		_delay_us(10);
+	uint8_t level = PHY_ED_LEVEL;
+	return (level > RF_ED_MAX) ? RF_ED_MAX : level;	// 0xFF is a measurement which did not finish
+}
 
-	// After the byte is sent the radio is set back into the RX waiting state.
-	TRX_STATE = (TRX_STATE & 0xE0) | RX_ON;
+// return the radio to the receive state
+static void _rf_rx_on() {
+	if (_rf_extended && (_RF_TRX_STATUS() == TX_ARET_ON)) {
+		TRX_STATE = (TRX_STATE & 0xE0) | PLL_ON;
+		_rf_wait_status(PLL_ON);
+	}
+	TRX_STATE = (TRX_STATE & 0xE0) | _RF_RX_ON();
 }
 
+// start the next queued frame, or return to receiving if there are none
+// called with interrupts disabled or from one of the transceiver interrupts
+static void _rf_tx_next() {
+	if (!_RF_TX_COUNT()) {
+		_rf_tx_state = RF_TX_STATE_IDLE;
+		_rf_rx_on();
+		return;
+	}
 
-// This interrupt is called when radio TX is complete. We'll just
-// ISR(TRX24_TX_END_vect) { }	// not used
+	if (_RF_TRX_STATUS() != _RF_TX_ON()) {
+		// from RX_ON this takes about 1us; while a frame is being received it waits for the end of the frame
+		TRX_STATE = (TRX_STATE & 0xE0) | PLL_ON;
+		if (!_rf_tx_ready()) {
+			// the RX_END or PLL_LOCK interrupt will start the frame
+			_rf_tx_state = RF_TX_STATE_WAITING;
+			return;
+		}
+	}
+	_rf_tx_start();
+}
 
+// the radio may have reached PLL_ON so a waiting frame may be started
+static void _rf_tx_resume() {
+	if ((_rf_tx_state == RF_TX_STATE_WAITING) && _rf_tx_ready())
+		_rf_tx_start();
+}
+
+// This interrupt is called when radio TX is complete. The radio is ready to send so the next frame may start immediately.
+// In extended mode, TRAC_STATUS has the result of the CSMA-CA and the retries.
 ISR(TRX24_TX_END_vect) {
+	if (_rf_tx_state != RF_TX_STATE_SENDING)
+		return;
+
+	uint8_t status = RF_TX_SUCCESS;
+	if (_rf_extended) {
+		status = (TRX_STATE & 0xE0) >> 5;
+		if (status == (STAT_SUCCESS_DATA_PENDING >> 5))
+			status = RF_TX_SUCCESS;
+	}
+
+	if (_rf_lpl_stretch) {
+		// repeat the frame until every sleeping receiver has woken, or it has been acknowledged
+		bool acked = _rf_extended && (status == RF_TX_SUCCESS) && (_rf_tx_frames[_rf_tx_tail & (RF_TX_FRAMES - 1)].data[0] & _RF_FCF_ACK_REQUEST);
+		if (!acked && ((clockMillis() - _rf_tx_started) < _rf_lpl_stretch)) {
+			_rf_tx_start();
+			return;
+		}
+	}
+
+	if (_rf_tx_result_hook && _rf_extended) {
+		// a frame which was not acknowledged may be sent again with more power
+		RFTXSLOT *slot = &(_rf_tx_frames[_rf_tx_tail & (RF_TX_FRAMES - 1)]);
+		if ((slot->data[0] & _RF_FCF_ACK_REQUEST) && _rf_tx_result_hook(slot->data[5] | (slot->data[6] << 8), status)) {
+			_rf_tx_start();
+			return;
+		}
+	}
+
+	_rf_tx_status[_rf_tx_tail & (RF_TX_FRAMES - 1)] = status;
+	_rf_tx_tail++;
+	_rf_tx_state = RF_TX_STATE_WAITING;
+	_rf_tx_next();
 	//_rf_tx_debug = 0 - _rf_tx_debug; // used to track state for debugging RF issues
 }
 
+// This interrupt is called when the PLL locks; eg: after leaving TRX_OFF
+ISR(TRX24_PLL_LOCK_vect) {
+	_rf_tx_resume();
+}
+
+int rfSendFrame(const uint8_t *data, uint8_t length);
+int rfSendTo(uint16_t address, const uint8_t *data, uint8_t length);
+
+// collect the bytes from the TX buffer into frames and queue them
+void RF_TX_FRAME() {
+	uint8_t frame[RF_FRAME_DATA_SIZE];
+	uint8_t length;
+	uint8_t size = _rf_tx_frame_hook ? _rf_tx_frame_hook_size : (_rf_extended ? RF_FRAME_PAYLOAD_SIZE : RF_FRAME_DATA_SIZE);
+
+	while (!ringEmpty(&_rf_tx_ring)) {
+		length = ringRead(&_rf_tx_ring, frame, size - 1);
+		frame[length++] = 0;
+
+		// only wait if the queue is full; a slot frees as soon as a frame is sent; a full frame takes 4.3ms at 250kb/s but only 0.7ms at 2Mb/s
+		uint16_t attempts = 2500;	// 2500 * 20us = 50ms is the maximum we will wait to queue the frame
+		while (((_rf_tx_frame_hook ? _rf_tx_frame_hook(frame, length) : (_rf_extended ? rfSendTo(RF_BROADCAST, frame, length) : rfSendFrame(frame, length))) < 0) && --attempts)
+			_delay_us(20);
+	}
+}
+
+
 // This interrupt is called when data is received by the radio. It gives us an opportunity to grab signal strength
 ISR(TRX24_RX_START_vect) {
 	/*
@@ -232,28 +536,118 @@ ISR(TRX24_RX_START_vect) {
 		·   RSSI = 28 (Indicates power higher or equal to -10 dbm)
 	*/
 	_rf_signal = PHY_RSSI; // Read in the received signal strength
+	_rf_rx_activity++;
+	_rf_rx_heard++;
 	//_rf_rx_debug = 0;
 }
 
-// This interrupt is called at the end of data receipt.
-// We can now get the data received and store it in the receive buffer.
-ISR(TRX24_RX_END_vect) {
-	// The received signal must be above a certain threshold.
-	if (_rf_signal & RX_CRC_VALID) {
-		uint8_t length;
-		uint8_t frame[RF_RX_BUFFER_SIZE];
-
-		length = TST_RX_LENGTH;						 // first byte is length of received bytes
-		memcpy(&frame[0], (void *)&TRXFBST, length); // remaining bytes are the data
-
-		// there are 2 extra bytes; we know one is the LQI; the other might(?) be the CRC? ... not sure
-		// copy from to our receive buffer
-		for (int i = 0; i < (length - 2); i++) {
-			if (bufferPut(&(_rf_obj.rxBuffer), frame[i]) < 0)
-				_rf_obj.rxOverflow++; // no space in buffer; count overflow
+// In extended mode this interrupt replaces RX_START. It is only called once the address of the frame matches this device,
+// so frames for other devices and groups are dropped by the transceiver without interrupting the CPU.
+ISR(TRX24_AMI_vect) {
+	_rf_signal = PHY_RSSI;
+	_rf_rx_activity++;
+	if (!RF_FILTER_STATS)
+		_rf_rx_heard++;	// otherwise RX_START has counted it
+}
+
+// return the next free slot of the receive ring with the details of the frame being received filled in, or NULL if the ring is full
+// protocol handlers use this to put their data in the ring; the slot is not used until _rf_rx_commit()
+static uint8_t _rf_rx_lqi;
+static uint16_t _rf_rx_source;
+static RFFRAME *_rf_rx_reserve() {
+	if (_RF_RX_COUNT() >= RF_RX_FRAMES) {
+		_rf_obj.rxOverflow++; // no space in buffer; count overflow
+		return NULL;
+	}
+
+	RFFRAME *frame = &(_rf_rx_frames[_rf_rx_head & (RF_RX_FRAMES - 1)]);
+	frame->rssi = _rf_signal & 0x1F;
+	frame->lqi = _rf_rx_lqi;
+	frame->source = _rf_rx_source;
+	return frame;
+}
+
+// add the reserved slot, with 'length' bytes of data, to the receive ring
+static void _rf_rx_commit(uint8_t length) {
+	RFFRAME *frame = &(_rf_rx_frames[_rf_rx_head & (RF_RX_FRAMES - 1)]);
+	frame->data[length] = 0;
+	frame->length = length;
+	_rf_rx_head++;
+}
+
+// The frame is copied from the frame buffer directly into the next free slot of the receive ring.
+static void _rf_rx_store() {
+	// the CRC result is only valid at the end of the frame
+	if (!(PHY_RSSI & (1 << RX_CRC_VALID)))
+		return;
+
+	uint8_t length = TST_RX_LENGTH;	// the length of the frame, including the 2 byte FCS
+	if ((length < 2) || (length > HW_FRAME_TX_SIZE))
+		return;
+	length -= 2;
+
+	uint8_t *bp = (uint8_t *)&TRXFBST;
+	_rf_rx_lqi = bp[length + 2];	// the LQI follows the frame in the frame buffer
+	uint16_t source = RF_ADDRESS_NONE;
+
+	if (_rf_extended) {
+		// only data frames with the addressing used by rfSendTo() are accepted; the header is removed
+		if ((length < RF_MAC_HEADER_SIZE) || (((bp[0] | (bp[1] << 8)) & _RF_FCF_MASK) != _RF_FCF_DATA))
+			return;
+		source = bp[7] | (bp[8] << 8);
+		if ((source == _rf_rx_last_source) && (bp[2] == _rf_rx_last_sequence)) {
+			_rf_rx_duplicates++;	// a retry of a frame we have; our ACK was lost
+			return;
+		}
+		_rf_rx_last_source = source;
+		_rf_rx_last_sequence = bp[2];
+		if (_rf_rx_link_hook)
+			_rf_rx_link_hook(source, _rf_signal & 0x1F, _rf_rx_lqi);
+		bp += RF_MAC_HEADER_SIZE;
+		length -= RF_MAC_HEADER_SIZE;
+	} else if (_rf_lpl_stretch) {
+		// a repeat of the last frame has the same FCS
+		uint16_t fcs = bp[length] | (bp[length + 1] << 8);
+		uint32_t now = clockMillis();
+		if ((fcs == _rf_rx_last_fcs) && ((now - _rf_rx_last_time) <= _rf_lpl_stretch)) {
+			_rf_rx_duplicates++;
+			_rf_rx_last_time = now;
+			return;
+		}
+		_rf_rx_last_fcs = fcs;
+		_rf_rx_last_time = now;
+	}
+	_rf_rx_source = source;
+	_rf_rx_delivered++;
+
+	if (length && (bp[0] >= RF_PROTOCOL_MIN)) {
+		for (uint8_t i = 0; i < RF_HANDLERS; i++) {
+			if (_rf_handlers[i] && (_rf_handler_ids[i] == bp[0])) {
+				if (_rf_handlers[i](bp, length, source))
+					return;
+				break;
+			}
 		}
-		//_rf_rx_debug = length;
 	}
+
+	if (_rf_rx_secure_only) {
+		_rf_rx_insecure++;	// a frame without protection while rfsecure.h is in use
+		return;
+	}
+
+	RFFRAME *frame = _rf_rx_reserve();
+	if (!frame)
+		return;
+	memcpy(frame->data, bp, length);
+	_rf_rx_commit(length);
+	//_rf_rx_debug = length;
+}
+
+// This interrupt is called at the end of data receipt.
+// A frame waiting to be sent may start once the frame has been received.
+ISR(TRX24_RX_END_vect) {
+	_rf_rx_store();
+	_rf_tx_resume();
 }
 
 bool _rf_off_state() {
@@ -292,6 +686,8 @@ Initialize the RF transceiver on the specified channel.
 
 The RF Transceiver has 16 possible channels (1 .. 16)
 
+The data rate is `RF_DATA_RATE`, or the rate last set with `rfDataRateSet()`.
+
 Must be called to initialize the RF transceiver prior to using any other RF functions.
 --- */
 void rfInit(uint8_t channel) {
@@ -307,8 +703,18 @@ void rfInit(uint8_t channel) {
 	uint8_t physical_channel = channel + 10;
 
 	// initialize the buffers
-	bufferReset(&(_rf_obj.rxBuffer), rfRxData, RF_RX_BUFFER_SIZE); // initialize the receive buffer
-	bufferReset(&(_rf_obj.txBuffer), rfTxData, RF_TX_BUFFER_SIZE); // initialize the transmit buffer
+	_rf_rx_head = _rf_rx_tail = 0;
+	_rf_rx_read = 0;
+	_rf_tx_head = _rf_tx_tail = 0;
+	_rf_tx_state = RF_TX_STATE_IDLE;
+	ringReset(&_rf_tx_ring, rfTxData, RF_TX_BUFFER_SIZE); // initialize the transmit buffer
+
+	// the reset below clears the address registers so the radio starts in basic mode
+	_rf_extended = false;
+	_rf_rx_last_source = RF_ADDRESS_NONE;
+	_rf_rx_duplicates = 0;
+	_rf_rx_heard = _rf_rx_delivered = 0;
+	_rf_lpl_stretch = 0;
 
 	//cli(); // prevent interrupts
 
@@ -329,8 +735,12 @@ void rfInit(uint8_t channel) {
 	// We'll use this register to turn on automatic CRC calculations.
 	TRX_CTRL_1 |= (1 << TX_AUTO_CRC_ON); // Enable automatic CRC calc.
 
-	// Enable RX start/end and TX end interrupts
-	IRQ_MASK = (1 << RX_START_EN) | (1 << RX_END_EN) | (1 << TX_END_EN);
+	// Transceiver Control Register 2 - TRX_CTRL_2
+	// The data rate; the reset above returns it to 250kb/s.
+	TRX_CTRL_2 = (TRX_CTRL_2 & ~((1 << OQPSK_DATA_RATE1) | (1 << OQPSK_DATA_RATE0))) | _rf_data_rate;
+
+	// Enable RX start/end, TX end, and PLL lock interrupts
+	IRQ_MASK = (1 << RX_START_EN) | (1 << RX_END_EN) | (1 << TX_END_EN) | (1 << PLL_LOCK_EN);
 
 	// Transceiver Clear Channel Assessment (CCA) -- PHY_CC_CCA
 	// This register is used to set the channel. CCA_MODE should default
@@ -341,7 +751,7 @@ void rfInit(uint8_t channel) {
 
 	// set power
 
-	PHY_TX_PWR &= ~(TX_PWR3 | TX_PWR2 | TX_PWR1 | TX_PWR0); // clear any existing bits
+	PHY_TX_PWR &= ~((1 << TX_PWR3) | (1 << TX_PWR2) | (1 << TX_PWR1) | (1 << TX_PWR0)); // clear any existing bits
 	//PHY_UART_TX_PWR |= ();	// set the bits we want; all bits 0 = full power
 
 	// tweak timing of power amplifier switch receive and transmit
@@ -381,6 +791,11 @@ void rfTerm() {
 	_rf_obj.rxOverflow = 0;
 	_rf_obj.txIdle = true;
 
+	// anything still queued is dropped
+	_rf_tx_tail = _rf_tx_head;
+	_rf_tx_state = RF_TX_STATE_IDLE;
+	_rf_lpl_stretch = 0;
+
 	_rf_off_state();
 
 	TRXPR = 1 << SLPTR; // if the transceiver state is TRX_OFF then sleep
@@ -401,6 +816,284 @@ uint8_t rfInited() {
 	return _rf_obj.inited;
 }
 
+/* ---
+#### bool rfChannelSet(uint8_t channel)
+
+Move the RF transceiver to another channel (1 .. 16) once anything being sent has finished.
+
+Returns false if the transceiver is not inited, the channel is not valid, or what was being sent did not finish.
+--- */
+bool rfChannelSet(uint8_t channel) {
+	if (!_rf_obj.inited || (channel < RF_CHANNEL_MIN) || (channel > RF_CHANNEL_MAX))
+		return false;
+
+	if (!_rf_tx_idle())
+		return false;
+
+	// the PLL settles on the new channel in about 11us; frames may be sent once it locks
+	PHY_CC_CCA = (PHY_CC_CCA & 0xE0) | (channel + 10);
+	_rf_obj.inited = channel;
+	return true;
+}
+
+// at the high data rates the acknowledgement is sent after 2 symbols (32us) rather than the 12 symbols of IEEE 802.15.4
+static void _rf_ack_time() {
+	if (_rf_data_rate == RF_RATE_250K)
+		XAH_CTRL_1 &= ~(1 << AACK_ACK_TIME);
+	else
+		XAH_CTRL_1 |= (1 << AACK_ACK_TIME);
+}
+
+/* ---
+#### bool rfDataRateSet(uint8_t rate)
+
+Change the data rate to `RF_RATE_250K`, `RF_RATE_500K`, `RF_RATE_1M`, or `RF_RATE_2M` once anything being sent has finished.
+The rate is kept when the RF transceiver is turned off and on again with `rfTerm()` and `rfInit()`.
+
+Returns false if the transceiver is not inited, the rate is not valid, or what was being sent did not finish.
+--- */
+bool rfDataRateSet(uint8_t rate) {
+	if (!_rf_obj.inited || (rate > RF_RATE_2M))
+		return false;
+
+	if (!_rf_tx_idle())
+		return false;
+
+	uint8_t sreg = SREG;
+	cli();
+
+	// a frame being received is abandoned
+	TRX_STATE = (TRX_STATE & 0xE0) | CMD_FORCE_PLL_ON;
+	_rf_wait_status(PLL_ON);
+	_rf_data_rate = rate;
+	TRX_CTRL_2 = (TRX_CTRL_2 & ~((1 << OQPSK_DATA_RATE1) | (1 << OQPSK_DATA_RATE0))) | rate;
+	_rf_ack_time();
+	TRX_STATE = (TRX_STATE & 0xE0) | _RF_RX_ON();
+
+	SREG = sreg;
+	return true;
+}
+
+/* ---
+#### uint8_t rfDataRate()
+
+Return the data rate; `RF_RATE_250K` .. `RF_RATE_2M`.
+--- */
+uint8_t rfDataRate() {
+	return _rf_data_rate;
+}
+
+/* ---
+#### uint16_t rfAirtime(uint8_t length)
+
+Return the microseconds taken to send a frame with `length` bytes of data at the current data rate.
+In extended mode the `RF_MAC_HEADER_SIZE` byte header is part of the data.
+
+The preamble, start of frame, and length (6 bytes) are always sent at 250kb/s; the data and the FCS are sent at the data rate.
+eg: a full frame takes 4256us at 250kb/s and 700us at 2Mb/s.
+--- */
+uint16_t rfAirtime(uint8_t length) {
+	return 192 + ((((uint16_t)length + 2) * 32) >> _rf_data_rate);
+}
+
+
+/* ---
+#### void rfAddressSet(uint16_t pan_id, uint16_t address)
+
+Switch the RF transceiver to extended mode using the given PAN ID and short address.
+
+In extended mode the transceiver does the work of IEEE 802.15.4 framing in hardware:
+- received frames are only kept if they are addressed to this device (or broadcast) on the same PAN and have a valid CRC;
+the others are dropped by the transceiver without interrupting the CPU (see `rfFramesDelivered()`)
+- received frames which ask for an acknowledgement are acknowledged automatically
+- `rfSendTo()` frames are sent after waiting for a clear channel (CSMA-CA) and are retried until they are acknowledged
+
+The header is removed from received frames; the sender is available from the `source` field of the `RFFRAME`.
+A frame which is received twice because its acknowledgement was lost is dropped. See `rfDuplicatesDropped()`.
+The number of retries is set at compile time with `RF_FRAME_RETRIES` and `RF_CSMA_RETRIES`.
+
+**Note:** Only devices in extended mode with the same PAN ID can communicate with each other.
+The byte functions, eg: `rfPutString()`, broadcast their data in extended mode.
+Nothing is changed if what was being sent does not finish.
+--- */
+void rfAddressSet(uint16_t pan_id, uint16_t address) {
+	if (!_rf_obj.inited)
+		return;
+
+	// let anything being sent finish before changing state
+	if (!_rf_tx_idle())
+		return;
+
+	// the CSMA-CA backoff must be different on each device; the radio only makes random bits, 2 each microsecond,
+	// while it listens in basic mode, so they are read before leaving it
+	uint8_t seed = _rf_tx_sequence;
+	if (!_rf_extended) {
+		for (uint8_t i = 0; (i < 50) && (_RF_TRX_STATUS() != RX_ON); i++)
+			_delay_us(10);	// rfInit() leaves the PLL to lock
+		for (uint8_t i = 0; i < 4; i++) {
+			seed = (seed << 2) | ((PHY_RSSI >> 5) & 0x03);
+			_delay_us(1);
+		}
+	}
+
+	uint8_t sreg = SREG;
+	cli();
+
+	// a frame being received is abandoned; the extended states can only be entered from PLL_ON
+	TRX_STATE = (TRX_STATE & 0xE0) | CMD_FORCE_PLL_ON;
+	_rf_wait_status(PLL_ON);
+
+	_rf_pan_id = pan_id;
+	_rf_address = address;
+	PAN_ID_0 = pan_id & 0xFF;
+	PAN_ID_1 = pan_id >> 8;
+	SHORT_ADDR_0 = address & 0xFF;
+	SHORT_ADDR_1 = address >> 8;
+
+	XAH_CTRL_0 = (RF_FRAME_RETRIES << 4) | (RF_CSMA_RETRIES << 1);
+	_rf_ack_time();
+
+	CSMA_SEED_0 = seed ^ (address & 0xFF);
+	CSMA_SEED_1 = (CSMA_SEED_1 & 0xF8) | ((seed ^ (address >> 8)) & 0x07);
+
+	_rf_extended = true;
+	_rf_tx_sequence = seed;
+	_rf_rx_last_source = RF_ADDRESS_NONE;
+
+	// only frames which pass the address filter interrupt the CPU
+	if (!RF_FILTER_STATS)
+		IRQ_MASK &= ~(1 << RX_START_EN);
+	IRQ_MASK |= (1 << AMI_EN);
+
+	TRX_STATE = (TRX_STATE & 0xE0) | RX_AACK_ON;
+
+	SREG = sreg;
+}
+
+/* ---
+#### void rfAddressClear()
+
+Return the RF transceiver to basic mode, where every frame is received and frames are sent as is.
+Nothing is changed if what was being sent does not finish.
+--- */
+void rfAddressClear() {
+	if (!_rf_obj.inited || !_rf_extended)
+		return;
+
+	if (!_rf_tx_idle())
+		return;
+
+	uint8_t sreg = SREG;
+	cli();
+
+	TRX_STATE = (TRX_STATE & 0xE0) | CMD_FORCE_PLL_ON;
+	_rf_wait_status(PLL_ON);
+	_rf_extended = false;
+	IRQ_MASK = (IRQ_MASK & ~(1 << AMI_EN)) | (1 << RX_START_EN);
+	TRX_STATE = (TRX_STATE & 0xE0) | RX_ON;
+
+	SREG = sreg;
+}
+
+/* ---
+#### uint16_t rfAddress()
+
+Return the short address set with `rfAddressSet()`, or `RF_ADDRESS_NONE` in basic mode.
+--- */
+uint16_t rfAddress() {
+	return _rf_extended ? _rf_address : RF_ADDRESS_NONE;
+}
+
+/* ---
+#### uint16_t rfAddressDefault()
+
+Return a short address for this device made from its signature (see `eepromSignature()`), for use with `rfAddressSet()`.
+Devices are very unlikely to share an address; it is never `RF_BROADCAST` or `RF_ADDRESS_NONE`.
+`eepromInit()` must be called first.
+
+eg:
+```C
+rfAddressSet(MY_GROUP, rfAddressDefault());
+```
+--- */
+uint16_t rfAddressDefault() {
+	const char *id = eepromSignature();
+	uint16_t hash = 5381;
+	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
+		hash = (hash * 33) ^ id[i];
+	return (hash >= RF_ADDRESS_NONE) ? (hash & 0x7FFF) : hash;
+}
+
+/* ---
+#### uint16_t rfFramesHeard()
+
+Return the number of frames the RF transceiver started to receive, whoever they were for.
+In extended mode frames for other devices are only counted when `RF_FILTER_STATS` is 1;
+otherwise only the frames which passed the address filter are counted. Either way it is never less than `rfFramesDelivered()`.
+--- */
+uint16_t rfFramesHeard() {
+	return _rf_rx_heard;
+}
+
+/* ---
+#### uint16_t rfFramesDelivered()
+
+Return the number of frames received for this device; the difference from `rfFramesHeard()` is the frames filtered out,
+including those with a bad CRC and duplicates. In extended mode the frames for other devices are only part of the difference
+when `RF_FILTER_STATS` is 1.
+--- */
+uint16_t rfFramesDelivered() {
+	return _rf_rx_delivered;
+}
+
+/* ---
+#### uint16_t rfDuplicatesDropped()
+
+Return the number of received frames dropped because they had already been received.
+This happens when the sender does not get the acknowledgement and sends the frame again,
+and when frames are repeated for low power listening (see `rflpl.h`).
+--- */
+uint16_t rfDuplicatesDropped() {
+	return _rf_rx_duplicates;
+}
+
+/* ---
+#### bool rfHandlerSet(uint8_t protocol, RFHANDLER handler)
+
+Register the handler for received frames which start with the `protocol` ID byte, or remove it when `handler` is NULL.
+The handler is called from the receive interrupt while the frame is still in the transceiver frame buffer,
+so it must be short and must copy anything it keeps. It returns true when it has used the frame.
+
+```C
+bool handler(const uint8_t *data, uint8_t length, uint16_t source);
+```
+
+Returns false if `protocol` is less than `RF_PROTOCOL_MIN` or all `RF_HANDLERS` are in use.
+--- */
+bool rfHandlerSet(uint8_t protocol, RFHANDLER handler) {
+	if (protocol < RF_PROTOCOL_MIN)
+		return false;
+
+	int8_t free = -1;
+	for (uint8_t i = 0; i < RF_HANDLERS; i++) {
+		if (_rf_handlers[i] && (_rf_handler_ids[i] == protocol)) {
+			free = i;
+			break;
+		}
+		if (!_rf_handlers[i] && (free < 0))
+			free = i;
+	}
+	if ((free < 0) || (!handler && !_rf_handlers[free]))
+		return (handler == NULL);
+
+	uint8_t sreg = SREG;
+	cli();
+	_rf_handler_ids[free] = protocol;
+	_rf_handlers[free] = handler;
+	SREG = sreg;
+	return true;
+}
+
 
 
 
@@ -414,8 +1107,9 @@ uint8_t rfInited() {
 Flush any pending data in the receive buffer (useful if you are waiting on a specifc message and have detected it is corrupted).
 --- */
 void rfFlushReceiveBuffer() {
-	// flush all data from receive buffer
-	bufferFlush(&(_rf_obj.rxBuffer));
+	// flush all frames from receive buffer
+	_rf_rx_tail = _rf_rx_head;
+	_rf_rx_read = 0;
 	_rf_obj.rxOverflow = 0;
 }
 
@@ -435,6 +1129,49 @@ uint8_t rfReceiveBufferOverflow() {
 ### Read Functions
 --- */
 
+/* ---
+#### RFFRAME* rfReceiveFrame()
+
+Return the oldest received frame, or NULL if there are none.
+The frame is used in place; it remains valid, and its slot remains in use, until `rfReleaseFrame()` is called.
+
+eg:
+```C
+RFFRAME *frame;
+while ((frame = rfReceiveFrame())) {
+	handleMessage((char *)frame->data, frame->length, frame->rssi);
+	rfReleaseFrame();
+}
+```
+
+**Note:** Do not mix this with the byte functions - `rfGetByte()` and `rfGetBuffer()` - for the same frame.
+--- */
+RFFRAME* rfReceiveFrame() {
+	if (!_rf_obj.inited || !_RF_RX_COUNT())
+		return NULL;
+	return &(_rf_rx_frames[_rf_rx_tail & (RF_RX_FRAMES - 1)]);
+}
+
+/* ---
+#### void rfReleaseFrame()
+
+Release the oldest received frame so its slot may be used for a new frame.
+--- */
+void rfReleaseFrame() {
+	if (_RF_RX_COUNT())
+		_rf_rx_tail++;
+	_rf_rx_read = 0;
+}
+
+/* ---
+#### uint8_t rfFramesAvailable()
+
+Return the number of received frames which have not been released.
+--- */
+uint8_t rfFramesAvailable() {
+	return _RF_RX_COUNT();
+}
+
 /* ---
 #### int rfAvailable()
 
@@ -443,7 +1180,12 @@ Return the number of unread bytes in receive buffer.
 int rfAvailable() {
 	if (!_rf_obj.inited)
 		return -1;
-	return _rf_obj.rxBuffer.length;
+
+	int avail = 0;
+	uint8_t count = _RF_RX_COUNT();
+	for (uint8_t i = 0; i < count; i++)
+		avail += _rf_rx_frames[(_rf_rx_tail + i) & (RF_RX_FRAMES - 1)].length;
+	return avail - _rf_rx_read;
 }
 
 
@@ -453,9 +1195,18 @@ int rfAvailable() {
 Return a single byte from the receive buffer (getchar-style) returns -1 if no byte is available.
 --- */
 int rfGetByte() {
-	if (!_rf_obj.inited)
-		return -1;
-	return bufferGet(&(_rf_obj.rxBuffer));
+	RFFRAME *frame;
+
+	while ((frame = rfReceiveFrame())) {
+		if (_rf_rx_read < frame->length) {
+			int c = frame->data[_rf_rx_read++];
+			if (_rf_rx_read >= frame->length)
+				rfReleaseFrame();
+			return c;
+		}
+		rfReleaseFrame();	// an empty frame
+	}
+	return -1;
 }
 
 
@@ -464,6 +1215,9 @@ int rfGetByte() {
 
 Return up to `maxlen` bytes from the receive buffer into the `data` buffer.
 Returns the number of bytes stored in the `data` buffer.
+
+The bytes all come from a single frame so two messages are never merged.
+The rest of a frame which is larger than `maxlen` is returned by the next call.
 --- */
 int rfGetBuffer(uint8_t *data, uint8_t maxlen) {
 	if (!_rf_obj.inited)
@@ -471,12 +1225,17 @@ int rfGetBuffer(uint8_t *data, uint8_t maxlen) {
 
 	memset(data, 0, maxlen);
 
-	int avail = rfAvailable();
+	RFFRAME *frame = rfReceiveFrame();
+	if (!frame)
+		return 0;
+
+	int avail = frame->length - _rf_rx_read;
 	if (avail > maxlen)
 		avail = maxlen;
-	for (int i = 0; i < avail; i++) {
-		data[i] = bufferGet(&(_rf_obj.rxBuffer));
-	}
+	memcpy(data, &(frame->data[_rf_rx_read]), avail);
+	_rf_rx_read += avail;
+	if (_rf_rx_read >= frame->length)
+		rfReleaseFrame();
 	return avail;
 }
 
@@ -485,6 +1244,133 @@ int rfGetBuffer(uint8_t *data, uint8_t maxlen) {
 ### Write Functions
 --- */
 
+// return the next free slot of the transmit queue, or NULL if the queue is full
+static RFTXSLOT *_rf_tx_reserve() {
+	if (!_rf_obj.inited || (_RF_TX_COUNT() >= RF_TX_FRAMES))
+		return NULL;
+	return &(_rf_tx_frames[_rf_tx_head & (RF_TX_FRAMES - 1)]);
+}
+
+// add the reserved slot to the queue; the slot is filled first so the interrupt never sees a partial frame
+static uint8_t _rf_tx_commit() {
+	uint8_t ticket = _rf_tx_head;
+	_rf_tx_status[ticket & (RF_TX_FRAMES - 1)] = RF_TX_PENDING;
+
+	uint8_t sreg = SREG;
+	cli();
+	_rf_tx_head++;
+	if (_rf_tx_state == RF_TX_STATE_IDLE)
+		_rf_tx_next();
+	SREG = sreg;
+
+	return ticket;
+}
+
+/* ---
+#### int rfSendFrame(const uint8_t* data, uint8_t length)
+
+Queue a frame of up to `RF_FRAME_DATA_SIZE` bytes to be sent. The function does not wait for the frame to be sent.
+
+Returns a ticket for the frame, which may be used with `rfSendStatus()`, or -1 if the queue is full.
+
+**Note:** The frame is sent as is. In extended mode it must begin with an IEEE 802.15.4 header; use `rfSendTo()`.
+--- */
+int rfSendFrame(const uint8_t *data, uint8_t length) {
+	if (length > RF_FRAME_DATA_SIZE)
+		return -1;
+
+	RFTXSLOT *slot = _rf_tx_reserve();
+	if (!slot)
+		return -1;
+	memcpy(slot->data, data, length);
+	slot->length = length;
+	return _rf_tx_commit();
+}
+
+// reserve a slot and, in extended mode, write the header for 'address'; returns where the payload goes or NULL if the queue is full
+static uint8_t *_rf_tx_reserve_to(uint16_t address) {
+	RFTXSLOT *slot = _rf_tx_reserve();
+	if (!slot)
+		return NULL;
+	if (!_rf_extended)
+		return slot->data;
+
+	uint16_t fcf = _RF_FCF_DATA;
+	if (address != RF_BROADCAST)
+		fcf |= _RF_FCF_ACK_REQUEST;
+
+	uint8_t *bp = slot->data;
+	*bp++ = fcf & 0xFF;
+	*bp++ = fcf >> 8;
+	*bp++ = _rf_tx_sequence++;
+	*bp++ = _rf_pan_id & 0xFF;
+	*bp++ = _rf_pan_id >> 8;
+	*bp++ = address & 0xFF;
+	*bp++ = address >> 8;
+	*bp++ = _rf_address & 0xFF;
+	*bp++ = _rf_address >> 8;
+	return bp;
+}
+
+// add the slot from _rf_tx_reserve_to() to the queue once 'length' bytes of payload have been written
+static uint8_t _rf_tx_commit_to(uint8_t length) {
+	_rf_tx_frames[_rf_tx_head & (RF_TX_FRAMES - 1)].length = (_rf_extended ? RF_MAC_HEADER_SIZE : 0) + length;
+	return _rf_tx_commit();
+}
+
+/* ---
+#### int rfSendTo(uint16_t address, const uint8_t* data, uint8_t length)
+
+Queue a message of up to `RF_FRAME_PAYLOAD_SIZE` bytes for the device with the given short address, or `RF_BROADCAST`.
+The radio must be in extended mode; see `rfAddressSet()`.
+
+The transceiver waits for a clear channel, sends the frame, and retries until it is acknowledged.
+The result is available from `rfSendStatus()`; `RF_TX_SUCCESS` means the receiver acknowledged the frame.
+Broadcast frames are not acknowledged so they are only sent once.
+
+Returns a ticket for the frame or -1 if the queue is full.
+--- */
+int rfSendTo(uint16_t address, const uint8_t *data, uint8_t length) {
+	if (!_rf_extended || (length > RF_FRAME_PAYLOAD_SIZE))
+		return -1;
+
+	uint8_t *bp = _rf_tx_reserve_to(address);
+	if (!bp)
+		return -1;
+	memcpy(bp, data, length);
+	return _rf_tx_commit_to(length);
+}
+
+/* ---
+#### uint8_t rfSendQueueDepth()
+
+Return the number of frames waiting to be sent, including the frame being sent.
+--- */
+uint8_t rfSendQueueDepth() {
+	return _RF_TX_COUNT();
+}
+
+/* ---
+#### uint8_t rfSendStatus(uint8_t ticket)
+
+Return the status of a frame queued with `rfSendFrame()`: `RF_TX_PENDING`, `RF_TX_SUCCESS`,
+or `RF_TX_UNKNOWN` once `RF_TX_FRAMES` more frames have been queued after it.
+--- */
+uint8_t rfSendStatus(uint8_t ticket) {
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t head = _rf_tx_head;
+	uint8_t tail = _rf_tx_tail;
+	uint8_t status = _rf_tx_status[ticket & (RF_TX_FRAMES - 1)];
+	SREG = sreg;
+
+	if ((uint8_t)(ticket - tail) < (uint8_t)(head - tail))
+		return RF_TX_PENDING;
+	if ((uint8_t)(head - ticket) > RF_TX_FRAMES)
+		return RF_TX_UNKNOWN;
+	return status;
+}
+
 /* ---
 #### void rfTransmitNow()
 
@@ -492,6 +1378,8 @@ Transmit any data which hs been put into the TX buffer.
 
 This function is often used after a series of `rfPutByte()`, `rfPutBuffer()`, or `rfPutString()` calls.
 to transmit all of the data.
+
+The data is queued with `rfSendFrame()` so this only waits if the transmit queue is full.
 -- */
 void rfTransmitNow() {
 	if (!_rf_obj.inited)
@@ -513,9 +1401,9 @@ int rfPutByte(uint8_t txData) {
 	if (!_rf_obj.inited)
 		return -1;
 
-	int rtn = bufferPut(&(_rf_obj.txBuffer), txData);
+	int rtn = ringPut(&_rf_tx_ring, txData);
 
-	if (_rf_obj.txBuffer.length >= (HW_FRAME_TX_SIZE)) {
+	if (ringCount(&_rf_tx_ring) >= (HW_FRAME_TX_SIZE)) {
 		RF_TX_FRAME();
 	}
 
@@ -536,10 +1424,14 @@ int rfPutBuffer(uint8_t *data, uint8_t len) {
 	if (!_rf_obj.inited)
 		return -1;
 
-	for (uint8_t i = 0; i < len; i++)
-		bufferPut(&(_rf_obj.txBuffer), data[i]);	// bufferPut() will ignore any bytes that will not fit
+	// when the buffer fills, its contents are sent so the rest of the data fits
+	uint8_t written = ringWrite(&_rf_tx_ring, data, len);
+	while (written < len) {
+		RF_TX_FRAME();
+		written += ringWrite(&_rf_tx_ring, &(data[written]), len - written);
+	}
 
-	if (_rf_obj.txBuffer.length >= (HW_FRAME_TX_SIZE)) {
+	if (ringCount(&_rf_tx_ring) >= (HW_FRAME_TX_SIZE)) {
 		RF_TX_FRAME();
 	}
 
@@ -0,0 +1,231 @@
+/* ************************************************************************************
+* File:    rfchannel.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### RF Channel Survey
+**Find the Quietest Channel**
+
+When several groups work side by side on the same channel, they all slow each other down.
+`rfChannelSurvey()` sweeps all 16 channels using the energy detection (ED) measurement of the transceiver.
+Each channel is measured several times over a short dwell time and given a busy score,
+the average of the mean and the peak energy. Continuous noise and bursts of traffic both make a channel busy.
+
+`rfChannelAnnounce()` tells everyone still on the current channel to move to the new channel, and then moves,
+so a group migrates together. Devices which hear the announcement find the new channel with `rfChannelAnnounced()`.
+A group should only move when one device asks it to; if every device surveyed and announced on its own,
+each would move to the channel it found quietest. With low power listening, turn it on with `rfLplSet()` before announcing
+so the announcement is repeated long enough for sleeping devices to hear it.
+
+A device which was off while its group moved finds it again with `rfChannelFind()`, which listens on each channel in turn.
+
+The survey is set at compile time:
+```C
+*/
+#ifndef RF_CHANNEL_SAMPLES
+#define RF_CHANNEL_SAMPLES	8		// ED measurements of each channel; each takes 128us
+#endif
+#ifndef RF_CHANNEL_DWELL
+#define RF_CHANNEL_DWELL	20		// milliseconds spent on each channel; the full sweep takes about 16 times as long
+#endif
+#ifndef RF_CHANNEL_ANNOUNCE_REPEATS
+#define RF_CHANNEL_ANNOUNCE_REPEATS	3	// times the announcement is sent before moving
+#endif
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_RFCHANNEL_
+#define __SRXE_RFCHANNEL_
+
+#include "common.h"
+#include "rf.h"
+
+#define RF_PROTOCOL_CHANNEL	0x81	// protocol, channel
+
+#define _RF_CHANNEL_INTERVAL_US	(((RF_CHANNEL_DWELL * 1000UL) / RF_CHANNEL_SAMPLES) - 140)	// between the start of each measurement
+
+static uint8_t _rf_channel_scores[RF_CHANNEL_MAX];
+static volatile uint8_t _rf_channel_announced;
+
+// registered with rf.h; called from the receive interrupt
+static bool _rf_channel_handler(const uint8_t *data, uint8_t length, uint16_t source) {
+	if ((length >= 2) && (data[1] >= RF_CHANNEL_MIN) && (data[1] <= RF_CHANNEL_MAX))
+		_rf_channel_announced = data[1];
+	return true;
+}
+
+
+/* ---
+#### void rfChannelInit()
+
+Start listening for channel announcements. Call it once; it may be called before `rfInit()`, and the handler it sets is kept across `rfInit()` and `rfTerm()`.
+--- */
+
+void rfChannelInit() {
+	_rf_channel_announced = 0;
+	rfHandlerSet(RF_PROTOCOL_CHANNEL, _rf_channel_handler);
+}
+
+/* ---
+#### uint8_t rfChannelSurvey()
+
+Measure all 16 channels and return the quietest one.
+The current channel is kept unless another channel is quieter.
+
+Frames are not received during the survey. It takes about 16 x `RF_CHANNEL_DWELL` milliseconds.
+Returns 0 if the RF transceiver is not inited or what was being sent did not finish.
+--- */
+
+uint8_t rfChannelSurvey() {
+	uint8_t current = rfInited();
+	if (!current)
+		return 0;
+
+	if (!_rf_tx_idle())
+		return 0;
+
+	// only the plain receive state measures energy; received frames are ignored until the survey is done
+	uint8_t mask = IRQ_MASK;
+	IRQ_MASK = mask & ~((1 << RX_START_EN) | (1 << RX_END_EN));
+	TRX_STATE = (TRX_STATE & 0xE0) | CMD_FORCE_PLL_ON;
+	_rf_wait_status(PLL_ON);
+	TRX_STATE = (TRX_STATE & 0xE0) | RX_ON;
+
+	for (uint8_t channel = RF_CHANNEL_MIN; channel <= RF_CHANNEL_MAX; channel++) {
+		PHY_CC_CCA = (PHY_CC_CCA & 0xE0) | (channel + 10);
+		_delay_us(20);	// time for the PLL to settle on the channel
+
+		uint16_t sum = 0;
+		uint8_t peak = 0;
+		for (uint8_t i = 0; i < RF_CHANNEL_SAMPLES; i++) {
+			uint8_t level = _rf_ed_measure();
+			sum += level;
+			if (level > peak)
+				peak = level;
+			_delay_us(_RF_CHANNEL_INTERVAL_US);
+		}
+		_rf_channel_scores[channel - 1] = ((sum / RF_CHANNEL_SAMPLES) + peak) / 2;
+	}
+
+	PHY_CC_CCA = (PHY_CC_CCA & 0xE0) | (current + 10);
+	if (_rf_extended) {
+		TRX_STATE = (TRX_STATE & 0xE0) | PLL_ON;
+		_rf_wait_status(PLL_ON);
+		TRX_STATE = (TRX_STATE & 0xE0) | RX_AACK_ON;
+	}
+	IRQ_MASK = mask;
+
+	uint8_t best = current;
+	for (uint8_t channel = RF_CHANNEL_MIN; channel <= RF_CHANNEL_MAX; channel++) {
+		if (_rf_channel_scores[channel - 1] < _rf_channel_scores[best - 1])
+			best = channel;
+	}
+	return best;
+}
+
+/* ---
+#### uint8_t rfChannelScore(uint8_t channel)
+
+Return the busy score of a channel (1 .. 16) from the last survey; 0 (quiet) .. 83 (-7dBm or more).
+--- */
+
+uint8_t rfChannelScore(uint8_t channel) {
+	if ((channel < RF_CHANNEL_MIN) || (channel > RF_CHANNEL_MAX))
+		return RF_ED_MAX;
+	return _rf_channel_scores[channel - 1];
+}
+
+/* ---
+#### bool rfChannelAnnounce(uint8_t channel)
+
+Broadcast the move to a new channel on the current channel, wait for the announcements to be sent, then move.
+
+Returns false if the RF transceiver is not inited or the channel is not valid.
+--- */
+
+bool rfChannelAnnounce(uint8_t channel) {
+	if (!rfInited() || (channel < RF_CHANNEL_MIN) || (channel > RF_CHANNEL_MAX))
+		return false;
+	if (channel == rfInited())
+		return true;
+
+	for (uint8_t i = 0; i < RF_CHANNEL_ANNOUNCE_REPEATS; i++) {
+		uint8_t *bp;
+		uint8_t attempts = 50;
+		while (!(bp = _rf_tx_reserve_to(RF_BROADCAST)) && --attempts)
+			_delay_ms(1);
+		if (!bp)
+			break;
+		bp[0] = RF_PROTOCOL_CHANNEL;
+		bp[1] = channel;
+		_rf_tx_commit_to(2);
+	}
+
+	return rfChannelSet(channel);	// waits for the queue to be sent
+}
+
+/* ---
+#### uint8_t rfChannelFind(uint16_t dwell)
+
+Listen on each channel in turn, starting with the current one, for `dwell` milliseconds, and stay on the first channel where
+a frame is heard. In extended mode only frames of this device's group count (see `rfAddressSet()`); an announcement which is
+heard is followed. With low power listening the others repeat each frame for a whole interval, so `dwell` should be longer
+than the interval. Frames which are heard are received as usual.
+
+Takes up to 16 x `dwell` milliseconds when there is nothing to hear.
+Returns the channel, or 0 if nothing was heard and the transceiver stayed on the current channel.
+--- */
+
+uint8_t rfChannelFind(uint16_t dwell) {
+	uint8_t current = rfInited();
+	if (!current || !_rf_tx_idle())
+		return 0;
+
+	for (uint8_t n = 0; n < RF_CHANNEL_MAX; n++) {
+		uint8_t channel = ((current - 1 + n) % RF_CHANNEL_MAX) + 1;
+		rfChannelSet(channel);
+		uint8_t activity = _rf_rx_activity;
+		for (uint16_t ms = 0; ms < dwell; ms++) {
+			if (_rf_channel_announced) {
+				channel = _rf_channel_announced;
+				_rf_channel_announced = 0;
+				rfChannelSet(channel);
+				return channel;
+			}
+			if (_rf_rx_activity != activity)
+				return channel;
+			_delay_ms(1);
+		}
+	}
+	rfChannelSet(current);
+	return 0;
+}
+
+/* ---
+#### uint8_t rfChannelAnnounced()
+
+Return the channel announced by another device, or 0 if there has not been an announcement since the last call.
+
+eg:
+```C
+uint8_t channel = rfChannelAnnounced();
+if (channel)
+	rfChannelSet(channel);
+```
+--- */
+
+uint8_t rfChannelAnnounced() {
+	uint8_t channel = _rf_channel_announced;
+	_rf_channel_announced = 0;
+	return channel;
+}
+
+#endif // __SRXE_RFCHANNEL_
@@ -0,0 +1,223 @@
+/* ************************************************************************************
+* File:    rflpl.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### RF Low Power Listening
+**Sleep the Radio Between Messages**
+
+The RF transceiver uses about 12.5-14.5mA while it is listening, which makes it the largest drain on the battery
+of an idle device. With low power listening the transceiver sleeps and wakes every interval just long enough to measure
+the energy on the channel. It stays awake only when it hears something, and goes back to sleep once the channel has been
+quiet for `RF_LPL_LISTEN` milliseconds.
+
+So that a sleeping receiver does not miss a frame, each frame is repeated for a whole interval.
+Receivers drop the repeats; see `rfDuplicatesDropped()`.
+In extended mode (see `rfAddressSet()`) a frame for a single device stops repeating as soon as it is acknowledged.
+Every device in a group must use the same interval.
+
+`rfLplPoll()` must be called regularly, eg: each time through the main loop.
+`rfLplDutyCycle()` reports the portion of time the transceiver has been awake.
+
+The sampling is set at compile time:
+```C
+*/
+#ifndef RF_LPL_SAMPLES
+#define RF_LPL_SAMPLES		3		// energy measurements at each wake, 1ms apart, to span the gap between repeated frames
+#endif
+#ifndef RF_LPL_THRESHOLD
+#define RF_LPL_THRESHOLD	12		// energy detection level which counts as a transmission; 12 = -78dBm
+#endif
+#ifndef RF_LPL_LISTEN
+#define RF_LPL_LISTEN		20		// milliseconds to stay awake after the last sign of a transmission
+#endif
+
+#define RF_LPL_INTERVAL_MIN	50		// milliseconds
+#define RF_LPL_INTERVAL_MAX	2000
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_RFLPL_
+#define __SRXE_RFLPL_
+
+#include "common.h"
+#include "clock.h"
+#include "rf.h"
+
+static bool _rf_lpl_asleep;
+static uint16_t _rf_lpl_interval;
+static uint32_t _rf_lpl_time;			// when the radio went to sleep, or the last sign of a transmission while awake
+static uint8_t _rf_lpl_activity;		// the value of _rf_rx_activity when last checked
+
+static uint32_t _rf_lpl_start;			// milliseconds; when low power listening started
+static uint32_t _rf_lpl_awake_since;	// microseconds; when the radio last woke
+static uint32_t _rf_lpl_awake_ms;		// total time awake
+static uint16_t _rf_lpl_awake_us;		// the part of the total which is less than a millisecond
+
+// add the current wake period to the total
+static void _rf_lpl_account() {
+	uint32_t now = clockMicros();
+	uint32_t us = (now - _rf_lpl_awake_since) + _rf_lpl_awake_us;
+	_rf_lpl_awake_ms += us / 1000;
+	_rf_lpl_awake_us = us % 1000;
+	_rf_lpl_awake_since = now;
+}
+
+// true when a frame has started since the last check, or is being received
+static bool _rf_lpl_heard() {
+	uint8_t status = _RF_TRX_STATUS();
+	if ((_rf_rx_activity != _rf_lpl_activity) || (status == STAT_BUSY_RX) || (status == STAT_BUSY_RX_AACK)) {
+		_rf_lpl_activity = _rf_rx_activity;
+		return true;
+	}
+	return false;
+}
+
+static void _rf_lpl_sleep() {
+	_rf_lpl_account();
+	TRX_STATE = (TRX_STATE & 0xE0) | CMD_FORCE_TRX_OFF;
+	_rf_wait_status(TRX_OFF);
+	TRXPR |= (1 << SLPTR);
+	_rf_lpl_asleep = true;
+	_rf_lpl_time = clockMillis();
+}
+
+static void _rf_lpl_wake() {
+	TRXPR &= ~(1 << SLPTR);
+	for (uint8_t i = 0; (i < 50) && (_RF_TRX_STATUS() != TRX_OFF); i++)
+		_delay_us(10);	// the crystal oscillator takes about 240us to start
+	_rf_lpl_awake_since = clockMicros();
+	_rf_lpl_asleep = false;
+
+	uint8_t sreg = SREG;
+	cli();
+	if (_rf_tx_state == RF_TX_STATE_WAITING) {
+		// the PLL_LOCK interrupt starts the frame
+		TRX_STATE = (TRX_STATE & 0xE0) | PLL_ON;
+	} else {
+		TRX_STATE = (TRX_STATE & 0xE0) | _RF_RX_ON();
+		_delay_us(200);	// time for the PLL to lock
+	}
+	SREG = sreg;
+}
+
+// registered with rf.h so functions which wait for the transmit queue to empty do not wait on a sleeping radio
+static void _rf_lpl_wake_up() {
+	if (_rf_lpl_stretch && _rf_lpl_asleep) {
+		_rf_lpl_wake();
+		_rf_lpl_time = clockMillis();
+	}
+}
+
+
+/* ---
+#### bool rfLplSet(uint16_t interval)
+
+Start low power listening, waking every `interval` milliseconds (`RF_LPL_INTERVAL_MIN` .. `RF_LPL_INTERVAL_MAX`),
+or stop it and keep the transceiver listening when `interval` is 0.
+
+Longer intervals use less power but delay each message by up to the interval,
+and keep the channel busy for longer because every frame is repeated for the whole interval.
+It is stopped by `rfInit()` and `rfTerm()`.
+
+Returns false if the RF transceiver is not inited.
+--- */
+
+bool rfLplSet(uint16_t interval) {
+	if (!rfInited())
+		return false;
+
+	if (_rf_lpl_stretch && _rf_lpl_asleep)
+		_rf_lpl_wake();
+
+	if (interval) {
+		if (interval < RF_LPL_INTERVAL_MIN)
+			interval = RF_LPL_INTERVAL_MIN;
+		if (interval > RF_LPL_INTERVAL_MAX)
+			interval = RF_LPL_INTERVAL_MAX;
+	}
+	_rf_lpl_interval = interval;
+	_rf_lpl_stretch = interval ? (interval + RF_LPL_SAMPLES + 1) : 0;	// each frame must span a whole wake cycle
+
+	_rf_lpl_asleep = false;
+	_rf_lpl_time = _rf_lpl_start = clockMillis();
+	_rf_lpl_awake_since = clockMicros();
+	_rf_lpl_awake_ms = _rf_lpl_awake_us = 0;
+	_rf_lpl_activity = _rf_rx_activity;
+	_rf_lpl_wake_hook = _rf_lpl_wake_up;
+	return true;
+}
+
+/* ---
+#### void rfLplPoll()
+
+Wake the transceiver when it is time to sample the channel or there is a frame to send,
+and put it back to sleep once the channel is quiet.
+--- */
+
+void rfLplPoll() {
+	if (!_rf_lpl_stretch || !rfInited())
+		return;
+
+	uint32_t now = clockMillis();
+
+	if (_rf_lpl_asleep) {
+		bool sending = (_rf_tx_state != RF_TX_STATE_IDLE);
+		if (!sending && ((now - _rf_lpl_time) < _rf_lpl_interval))
+			return;
+
+		_rf_lpl_wake();
+		_rf_lpl_time = now;
+		if (sending)
+			return;
+
+		// a transmission is either under way or will repeat within the sampling time
+		_rf_lpl_activity = _rf_rx_activity;
+		for (uint8_t i = 0; i < RF_LPL_SAMPLES; i++) {
+			if ((_rf_ed_measure() >= RF_LPL_THRESHOLD) || _rf_lpl_heard())
+				return;
+			if (i < (RF_LPL_SAMPLES - 1))
+				_delay_ms(1);
+		}
+		_rf_lpl_sleep();
+		return;
+	}
+
+	if (_rf_lpl_heard() || (_rf_tx_state != RF_TX_STATE_IDLE) || (_rf_ed_measure() >= RF_LPL_THRESHOLD)) {
+		_rf_lpl_time = now;
+		return;
+	}
+	if ((now - _rf_lpl_time) >= RF_LPL_LISTEN)
+		_rf_lpl_sleep();
+}
+
+/* ---
+#### uint16_t rfLplDutyCycle()
+
+Return the portion of time the transceiver has been awake since `rfLplSet()`, in hundredths of a percent;
+eg: 125 is 1.25%. Returns 10000 (100%) when low power listening is not in use.
+--- */
+
+uint16_t rfLplDutyCycle() {
+	if (!_rf_lpl_stretch)
+		return 10000;
+
+	if (!_rf_lpl_asleep)
+		_rf_lpl_account();
+
+	uint32_t elapsed = (clockMillis() - _rf_lpl_start) / 100;
+	if (!elapsed)
+		return 10000;
+	uint32_t duty = (_rf_lpl_awake_ms * 100) / elapsed;
+	return (duty > 10000) ? 10000 : duty;
+}
+
+#endif // __SRXE_RFLPL_
@@ -0,0 +1,336 @@
+/* ************************************************************************************
+* File:    rfmesh.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### RF Mesh
+**Relay Messages Beyond the Range of One Radio**
+
+Mesh frames are relayed by every device which hears them, so a message reaches devices which cannot hear the sender
+directly. Each frame carries the ID of the device which sent it first (from `eepromSignature()`), a sequence number,
+and a hop limit which each relay reduces by one.
+
+Each device remembers the frames it has recently seen so it delivers and relays each one only once.
+A relay waits a random time of up to `RF_MESH_JITTER` milliseconds before sending, so neighbours which heard the same frame
+do not all send at once. If, while waiting, it hears `RF_MESH_SUPPRESS` other devices relay the frame,
+the area is already covered and it does not send.
+
+`rfMeshPoll()` must be called regularly, eg: each time through the main loop, to send the relays.
+`eepromInit()` must be called before `rfMeshSend()`.
+
+The mesh is set at compile time:
+```C
+*/
+#ifndef RF_MESH_HOPS
+#define RF_MESH_HOPS		4		// default hop limit; the frame is sent at most this many times in a line
+#endif
+#ifndef RF_MESH_JITTER
+#define RF_MESH_JITTER		32		// most milliseconds a relay waits before sending
+#endif
+#ifndef RF_MESH_SUPPRESS
+#define RF_MESH_SUPPRESS	2		// a waiting relay is dropped after hearing the frame from this many others
+#endif
+#ifndef RF_MESH_SEEN
+#define RF_MESH_SEEN		16		// recently seen frames which are remembered; must be a power of 2
+#endif
+#ifndef RF_MESH_RELAYS
+#define RF_MESH_RELAYS		2		// frames which may be waiting to be relayed
+#endif
+#ifndef RF_MESH_FRAMES
+#define RF_MESH_FRAMES		2		// received frames held until they are read; must be a power of 2
+#endif
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_RFMESH_
+#define __SRXE_RFMESH_
+
+#include "common.h"
+#include "clock.h"
+#include "eeprom.h"
+#include "rf.h"
+
+#define RF_PROTOCOL_MESH	0x82
+
+/* ---
+Received frames are an `RFMESHFRAME`:
+```C
+*/
+#define RF_MESH_HEADER_SIZE		10	// protocol, hops, origin ID (6), sequence (2)
+#define RF_MESH_PAYLOAD_SIZE	(RF_FRAME_PAYLOAD_SIZE - RF_MESH_HEADER_SIZE)
+
+typedef struct _RFMESHFRAME {
+	char origin[EEPROM_ID_SIZE + 1];	// the ID of the device which sent the frame
+	uint8_t hops;						// what was left of the hop limit when the frame arrived
+	uint8_t length;						// number of data bytes
+	uint8_t data[RF_MESH_PAYLOAD_SIZE + 1];	// the data is always followed by a 0 so text may be used in place
+} RFMESHFRAME;
+/*
+```
+--- */
+
+static uint32_t _rf_mesh_seen[RF_MESH_SEEN];	// hash of the origin ID in the high word and the sequence in the low word
+static uint8_t _rf_mesh_seen_next;
+
+typedef struct _RFMESHRELAY {
+	uint32_t key;			// 0 when the slot is free
+	uint32_t due;
+	uint8_t heard;			// times the frame was heard from others while waiting
+	uint8_t length;
+	uint8_t data[RF_FRAME_PAYLOAD_SIZE];
+} RFMESHRELAY;
+
+static RFMESHRELAY _rf_mesh_relays[RF_MESH_RELAYS];
+
+static RFMESHFRAME _rf_mesh_frames[RF_MESH_FRAMES];
+static volatile uint8_t _rf_mesh_head;
+static volatile uint8_t _rf_mesh_tail;
+
+static uint16_t _rf_mesh_sequence;
+static uint16_t _rf_mesh_prng;	// xorshift state for the relay delays; never 0
+static uint16_t _rf_mesh_forwarded, _rf_mesh_suppressed, _rf_mesh_expired;
+
+static uint16_t _rf_mesh_hash(const char *origin) {
+	uint16_t hash = 5381;
+	for (uint8_t i = 0; i < EEPROM_ID_SIZE; i++)
+		hash = (hash * 33) ^ origin[i];
+	return hash;
+}
+
+// frames are identified by their origin and sequence; 0 is never a valid key
+static uint32_t _rf_mesh_key(const char *origin, uint16_t sequence) {
+	uint32_t key = ((uint32_t)_rf_mesh_hash(origin) << 16) | sequence;
+	return key ? key : 1;
+}
+
+static bool _rf_mesh_seen_add(uint32_t key) {
+	for (uint8_t i = 0; i < RF_MESH_SEEN; i++) {
+		if (_rf_mesh_seen[i] == key)
+			return false;
+	}
+	_rf_mesh_seen[_rf_mesh_seen_next++ & (RF_MESH_SEEN - 1)] = key;
+	return true;
+}
+
+// 16 bits from the radio, which only makes random bits while it listens in basic mode; 2 new bits every microsecond
+static uint16_t _rf_mesh_radio_bits() {
+	uint16_t r = 0;
+	for (uint8_t i = 0; i < 8; i++) {
+		r = (r << 2) | ((PHY_RSSI >> 5) & 0x03);
+		_delay_us(1);
+	}
+	return r;
+}
+
+// the relay delays come from a PRNG seeded by rfMeshInit(), since the radio makes no random bits in extended mode
+static uint16_t _rf_mesh_random() {
+	_rf_mesh_prng ^= _rf_mesh_prng << 7;
+	_rf_mesh_prng ^= _rf_mesh_prng >> 9;
+	_rf_mesh_prng ^= _rf_mesh_prng << 8;
+	return _rf_mesh_prng;
+}
+
+// registered with rf.h; called from the receive interrupt
+static bool _rf_mesh_handler(const uint8_t *data, uint8_t length, uint16_t source) {
+	if (length < RF_MESH_HEADER_SIZE)
+		return true;
+
+	const char *origin = (const char *)&(data[2]);
+	uint32_t key = _rf_mesh_key(origin, data[8] | (data[9] << 8));
+
+	if (!_rf_mesh_seen_add(key)) {
+		// another device relayed a frame we have; maybe we need not relay it
+		for (uint8_t i = 0; i < RF_MESH_RELAYS; i++) {
+			if (_rf_mesh_relays[i].key == key)
+				_rf_mesh_relays[i].heard++;
+		}
+		return true;
+	}
+
+	if ((RF_MESH_FRAMES - (uint8_t)(_rf_mesh_head - _rf_mesh_tail)) > 0) {
+		RFMESHFRAME *frame = &(_rf_mesh_frames[_rf_mesh_head & (RF_MESH_FRAMES - 1)]);
+		memcpy(frame->origin, origin, EEPROM_ID_SIZE);
+		frame->origin[EEPROM_ID_SIZE] = 0;
+		frame->hops = data[1];
+		frame->length = length - RF_MESH_HEADER_SIZE;
+		memcpy(frame->data, &(data[RF_MESH_HEADER_SIZE]), frame->length);
+		frame->data[frame->length] = 0;
+		_rf_mesh_head++;
+	} else {
+		_rf_obj.rxOverflow++;
+	}
+
+	if (data[1] <= 1) {
+		_rf_mesh_expired++;
+		return true;
+	}
+
+	for (uint8_t i = 0; i < RF_MESH_RELAYS; i++) {
+		RFMESHRELAY *relay = &(_rf_mesh_relays[i]);
+		if (relay->key)
+			continue;
+		memcpy(relay->data, data, length);
+		relay->data[1]--;
+		relay->length = length;
+		relay->heard = 0;
+		relay->due = clockMillis() + (_rf_mesh_random() % RF_MESH_JITTER);
+		relay->key = key;
+		return true;
+	}
+	_rf_mesh_expired++;	// no room to relay it
+	return true;
+}
+
+
+/* ---
+#### void rfMeshInit()
+
+Start receiving and relaying mesh frames. Call it each time after `rfInit()` and before `rfAddressSet()`:
+the sequence numbers and relay delays start from random bits which the radio only makes while it listens in basic mode,
+mixed with the ID of the device so neighbours differ even if the radio bits do not. `eepromInit()` must be called first.
+--- */
+
+void rfMeshInit() {
+	memset(_rf_mesh_seen, 0, sizeof(_rf_mesh_seen));
+	memset(_rf_mesh_relays, 0, sizeof(_rf_mesh_relays));
+	_rf_mesh_head = _rf_mesh_tail = 0;
+	for (uint8_t i = 0; (i < 50) && (_RF_TRX_STATUS() != RX_ON); i++)
+		_delay_us(10);	// rfInit() leaves the PLL to lock
+	_rf_mesh_prng = _rf_mesh_radio_bits() ^ _rf_mesh_hash(eepromSignature());
+	if (!_rf_mesh_prng)
+		_rf_mesh_prng = 1;
+	_rf_mesh_sequence = _rf_mesh_random();	// so a restart does not repeat recent sequence numbers
+	rfHandlerSet(RF_PROTOCOL_MESH, _rf_mesh_handler);
+}
+
+/* ---
+#### bool rfMeshSend(const uint8_t *data, uint8_t length, uint8_t hops)
+
+Queue up to `RF_MESH_PAYLOAD_SIZE` bytes to be sent to every device within `hops` relays; 0 uses `RF_MESH_HOPS`.
+
+Returns false if the transmit queue is full or the data is too large.
+--- */
+
+bool rfMeshSend(const uint8_t *data, uint8_t length, uint8_t hops) {
+	if (length > RF_MESH_PAYLOAD_SIZE)
+		return false;
+
+	uint8_t *bp = _rf_tx_reserve_to(RF_BROADCAST);
+	if (!bp)
+		return false;
+
+	const char *origin = eepromSignature();
+	uint16_t sequence = ++_rf_mesh_sequence;
+
+	*bp++ = RF_PROTOCOL_MESH;
+	*bp++ = hops ? hops : RF_MESH_HOPS;
+	memcpy(bp, origin, EEPROM_ID_SIZE);
+	bp += EEPROM_ID_SIZE;
+	*bp++ = sequence & 0xFF;
+	*bp++ = sequence >> 8;
+	memcpy(bp, data, length);
+
+	// our own frame is not delivered or relayed when a neighbour relays it back
+	uint8_t sreg = SREG;
+	cli();
+	_rf_mesh_seen_add(_rf_mesh_key(origin, sequence));
+	SREG = sreg;
+
+	_rf_tx_commit_to(RF_MESH_HEADER_SIZE + length);
+	return true;
+}
+
+/* ---
+#### void rfMeshPoll()
+
+Send the relays which have waited long enough, unless enough neighbours have already relayed them.
+--- */
+
+void rfMeshPoll() {
+	if (!rfInited())
+		return;
+
+	uint32_t now = clockMillis();
+
+	for (uint8_t i = 0; i < RF_MESH_RELAYS; i++) {
+		RFMESHRELAY *relay = &(_rf_mesh_relays[i]);
+		if (!relay->key || ((int32_t)(now - relay->due) < 0))
+			continue;
+
+		if (relay->heard >= RF_MESH_SUPPRESS) {
+			_rf_mesh_suppressed++;
+		} else {
+			uint8_t *bp = _rf_tx_reserve_to(RF_BROADCAST);
+			if (!bp)
+				continue;	// try again next time
+			memcpy(bp, relay->data, relay->length);
+			_rf_tx_commit_to(relay->length);
+			_rf_mesh_forwarded++;
+		}
+		relay->key = 0;
+	}
+}
+
+/* ---
+#### RFMESHFRAME* rfMeshReceive()
+
+Return the oldest received mesh frame, or NULL if there are none.
+The frame remains valid until `rfMeshRelease()` is called.
+--- */
+
+RFMESHFRAME *rfMeshReceive() {
+	if (_rf_mesh_head == _rf_mesh_tail)
+		return NULL;
+	return &(_rf_mesh_frames[_rf_mesh_tail & (RF_MESH_FRAMES - 1)]);
+}
+
+/* ---
+#### void rfMeshRelease()
+
+Release the oldest received mesh frame.
+--- */
+
+void rfMeshRelease() {
+	if (_rf_mesh_head != _rf_mesh_tail)
+		_rf_mesh_tail++;
+}
+
+/* ---
+#### uint16_t rfMeshForwarded()
+
+Return the number of frames this device has relayed.
+--- */
+
+uint16_t rfMeshForwarded() {
+	return _rf_mesh_forwarded;
+}
+
+/* ---
+#### uint16_t rfMeshSuppressed()
+
+Return the number of frames which were not relayed because neighbours had already relayed them.
+--- */
+
+uint16_t rfMeshSuppressed() {
+	return _rf_mesh_suppressed;
+}
+
+/* ---
+#### uint16_t rfMeshExpired()
+
+Return the number of frames which were not relayed because their hop limit was used up, or every relay slot was busy.
+--- */
+
+uint16_t rfMeshExpired() {
+	return _rf_mesh_expired;
+}
+
+#endif // __SRXE_RFMESH_
@@ -0,0 +1,490 @@
+/* ************************************************************************************
+* File:    rfmsg.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### RF Messages
+**Messages Larger than One Frame**
+
+A frame holds at most 125 bytes and the receiver has no way to tell where a longer message,
+sent as several frames, ends. The message functions send a message of up to `RFMSG_MAX_SIZE` bytes
+as numbered fragments. Every fragment carries the message ID and the total length, so the receiver can
+start a message from whichever fragment arrives first.
+
+Fragments are received straight into their place in the final message buffer, which is taken from a fixed pool.
+The message is copied once on its way from the radio to the application and is read in place.
+Likewise, fragments are sent straight from the application's buffer.
+
+When fragments stop arriving the receiver asks the sender for just the ones it is missing, every `RFMSG_RETRY` milliseconds.
+A message which is still incomplete `RFMSG_TIMEOUT` milliseconds after its last fragment is dropped.
+With low power listening (see `rflpl.h`) each frame is repeated for a whole wake interval, so both waits grow by
+a few intervals: a request is not sent until the one before it is done, and a message is not dropped while
+its fragments are still in the sender's queue.
+Once a message is complete the receiver tells the sender so it can stop waiting.
+The receiver remembers the last `RFMSG_DONE` messages it completed, and answers any late fragment of one of them
+by telling the sender again, rather than taking it for the start of a new message.
+
+`rfMsgPoll()` must be called regularly, eg: each time through the main loop. It sends fragments and requests
+and handles timeouts. The `clock.h` functions must be running.
+
+The limits are set at compile time:
+```C
+*/
+#ifndef RFMSG_FRAGMENT_SIZE
+#define RFMSG_FRAGMENT_SIZE	100		// bytes of message in each fragment; at most RF_FRAME_PAYLOAD_SIZE - 6
+#endif
+#ifndef RFMSG_MAX_FRAGMENTS
+#define RFMSG_MAX_FRAGMENTS	20		// fragments in the largest message; at most 32
+#endif
+#ifndef RFMSG_POOL_SIZE
+#define RFMSG_POOL_SIZE		2048	// bytes of SRAM shared by the messages being received
+#endif
+#ifndef RFMSG_SLOTS
+#define RFMSG_SLOTS			3		// messages which may be received at the same time
+#endif
+#ifndef RFMSG_DONE
+#define RFMSG_DONE			4		// completed messages which are remembered
+#endif
+#ifndef RFMSG_RETRY
+#define RFMSG_RETRY			60		// milliseconds without a fragment before asking for the missing fragments
+#endif
+#ifndef RFMSG_TIMEOUT
+#define RFMSG_TIMEOUT		1000	// milliseconds without a fragment before an incomplete message is dropped
+#endif
+
+#define RFMSG_MAX_SIZE		(RFMSG_FRAGMENT_SIZE * RFMSG_MAX_FRAGMENTS)
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_RFMSG_
+#define __SRXE_RFMSG_
+
+#include "common.h"
+#include "clock.h"
+#include "rf.h"
+
+#define RF_PROTOCOL_MSG		0x80	// the first byte of every message frame
+
+#define _RFMSG_DATA			0		// protocol, type, id, index, length (2), fragment data
+#define _RFMSG_MISSING		1		// protocol, type, id, bitmap of missing fragments (4); no bits set means complete
+#define _RFMSG_DATA_HEADER	6
+#define _RFMSG_MISSING_SIZE	7
+
+#define _RFMSG_FREE			0
+#define _RFMSG_RECEIVING	1
+#define _RFMSG_COMPLETE		2		// waiting for the application
+#define _RFMSG_READING		3		// returned by rfMsgReceive()
+
+/* ---
+A received message is an `RFMSG`:
+```C
+*/
+typedef struct _RFMSG {
+	uint16_t source;		// short address of the sender in extended mode; RF_ADDRESS_NONE otherwise
+	uint16_t length;		// number of bytes of data
+	uint8_t *data;			// the message; it is always followed by a 0 so text may be used in place
+	// the remaining fields are used while the message is being received
+	uint8_t id;
+	volatile uint8_t state;
+	uint8_t retries;		// requests sent for missing fragments
+	uint16_t offset;		// the data is at this offset in the pool
+	volatile uint32_t missing;
+	volatile uint32_t time;	// when the last new fragment arrived
+} RFMSG;
+/*
+```
+--- */
+
+static RFMSG _rfmsg_slots[RFMSG_SLOTS];
+static uint8_t _rfmsg_pool[RFMSG_POOL_SIZE];
+static uint16_t _rfmsg_dropped;
+
+typedef struct _RFMSGDONE {
+	uint16_t source;
+	uint16_t length;
+	uint8_t id;
+	volatile bool confirm;	// the sender has not yet been told the message is complete
+} RFMSGDONE;
+
+static RFMSGDONE _rfmsg_done[RFMSG_DONE];
+static uint8_t _rfmsg_done_next;		// the entry which the next completed message replaces
+
+#define _RFMSG_TX_IDLE		0
+#define _RFMSG_TX_SENDING	1		// fragments are waiting to be queued
+#define _RFMSG_TX_WAITING	2		// all fragments are queued; waiting for the receiver to confirm or ask for more
+
+static const uint8_t *_rfmsg_tx_data;
+static uint16_t _rfmsg_tx_length;
+static uint16_t _rfmsg_tx_address;
+static uint8_t _rfmsg_tx_id;
+static uint8_t _rfmsg_tx_count;
+static volatile uint8_t _rfmsg_tx_state;
+static volatile uint32_t _rfmsg_tx_pending;	// fragments still to be queued; requests from the receiver add to it
+static volatile uint32_t _rfmsg_tx_time;	// when the last fragment was queued or the receiver last asked for more
+
+// with low power listening every frame takes _rf_lpl_stretch milliseconds to send
+#define _RFMSG_RETRY()		(RFMSG_RETRY + (2UL * _rf_lpl_stretch))
+#define _RFMSG_TIMEOUT()	(RFMSG_TIMEOUT + ((RF_TX_FRAMES + 2UL) * _rf_lpl_stretch))
+
+#define _RFMSG_FRAGMENTS(length)	(((length) + RFMSG_FRAGMENT_SIZE - 1) / RFMSG_FRAGMENT_SIZE)
+#define _RFMSG_ALL(count)			(((count) >= 32) ? 0xFFFFFFFFUL : ((1UL << (count)) - 1))
+
+// find space in the pool for 'size' bytes; returns the offset or -1 if there is no gap large enough
+static int16_t _rfmsg_pool_alloc(uint16_t size) {
+	uint16_t offset = 0;
+	uint8_t i = 0;
+
+	while (i < RFMSG_SLOTS) {
+		RFMSG *msg = &(_rfmsg_slots[i++]);
+		if ((msg->state == _RFMSG_FREE) || (offset >= (msg->offset + msg->length + 1)) || ((offset + size) <= msg->offset))
+			continue;
+		// overlaps this message; try just past it and check every message again
+		offset = msg->offset + msg->length + 1;
+		i = 0;
+	}
+	if ((offset + size) > RFMSG_POOL_SIZE)
+		return -1;
+	return offset;
+}
+
+// find the message a fragment belongs to, or start a new one
+static RFMSG *_rfmsg_slot(uint16_t source, uint8_t id, uint16_t length) {
+	RFMSG *free = NULL;
+
+	for (uint8_t i = 0; i < RFMSG_SLOTS; i++) {
+		RFMSG *msg = &(_rfmsg_slots[i]);
+		if (msg->state == _RFMSG_FREE) {
+			if (!free)
+				free = msg;
+		} else if ((msg->source == source) && (msg->id == id) && (msg->length == length)) {
+			return msg;
+		}
+	}
+	if (!free)
+		return NULL;
+
+	int16_t offset = _rfmsg_pool_alloc(length + 1);
+	if (offset < 0)
+		return NULL;
+
+	free->source = source;
+	free->id = id;
+	free->length = length;
+	free->offset = offset;
+	free->data = &(_rfmsg_pool[offset]);
+	free->missing = _RFMSG_ALL(_RFMSG_FRAGMENTS(length));
+	free->retries = 0;
+	free->state = _RFMSG_RECEIVING;
+	return free;
+}
+
+// the completed message a fragment belongs to, or NULL
+static RFMSGDONE *_rfmsg_done_find(uint16_t source, uint8_t id, uint16_t length) {
+	for (uint8_t i = 0; i < RFMSG_DONE; i++) {
+		RFMSGDONE *done = &(_rfmsg_done[i]);
+		if ((done->length == length) && (done->source == source) && (done->id == id))
+			return done;
+	}
+	return NULL;
+}
+
+// a fragment goes straight from the transceiver frame buffer to its place in the message
+static void _rfmsg_receive_data(const uint8_t *data, uint8_t length, uint16_t source) {
+	uint8_t index = data[3];
+	uint16_t total = data[4] | (data[5] << 8);
+	uint8_t count = _RFMSG_FRAGMENTS(total);
+
+	if (!total || (total > RFMSG_MAX_SIZE) || (index >= count))
+		return;
+
+	uint16_t offset = index * RFMSG_FRAGMENT_SIZE;
+	uint8_t size = ((total - offset) < RFMSG_FRAGMENT_SIZE) ? (total - offset) : RFMSG_FRAGMENT_SIZE;
+	if ((length - _RFMSG_DATA_HEADER) != size)
+		return;
+
+	RFMSGDONE *done = _rfmsg_done_find(source, data[2], total);
+	if (done) {
+		// the sender is still sending, so it did not hear that the message was complete
+		done->confirm = true;
+		return;
+	}
+
+	RFMSG *msg = _rfmsg_slot(source, data[2], total);
+	if (!msg) {
+		_rfmsg_dropped++;
+		return;
+	}
+
+	uint32_t bit = 1UL << index;
+	if (!(msg->missing & bit))
+		return;
+
+	memcpy(&(msg->data[offset]), &(data[_RFMSG_DATA_HEADER]), size);
+	msg->missing &= ~bit;
+	msg->time = clockMillis();
+	msg->retries = 0;
+
+	if (!msg->missing) {
+		msg->data[total] = 0;
+		msg->state = _RFMSG_COMPLETE;
+
+		done = &(_rfmsg_done[_rfmsg_done_next]);
+		_rfmsg_done_next = (_rfmsg_done_next + 1) % RFMSG_DONE;
+		done->source = source;
+		done->length = total;
+		done->id = msg->id;
+		done->confirm = true;
+	}
+}
+
+// the receiver wants more fragments, or has all of them
+static void _rfmsg_receive_missing(const uint8_t *data, uint16_t source) {
+	if ((_rfmsg_tx_state == _RFMSG_TX_IDLE) || (data[2] != _rfmsg_tx_id))
+		return;
+	if ((_rfmsg_tx_address != RF_BROADCAST) && (source != _rfmsg_tx_address))
+		return;
+
+	uint32_t missing = data[3] | ((uint32_t)data[4] << 8) | ((uint32_t)data[5] << 16) | ((uint32_t)data[6] << 24);
+	missing &= _RFMSG_ALL(_rfmsg_tx_count);
+
+	if (missing) {
+		_rfmsg_tx_pending |= missing;
+		_rfmsg_tx_state = _RFMSG_TX_SENDING;
+	} else if (_rfmsg_tx_address != RF_BROADCAST) {
+		// other receivers of a broadcast may still be missing fragments
+		_rfmsg_tx_state = _RFMSG_TX_IDLE;
+	}
+	_rfmsg_tx_time = clockMillis();
+}
+
+// registered with rf.h; called from the receive interrupt
+static bool _rfmsg_handler(const uint8_t *data, uint8_t length, uint16_t source) {
+	if ((data[1] == _RFMSG_DATA) && (length > _RFMSG_DATA_HEADER))
+		_rfmsg_receive_data(data, length, source);
+	else if ((data[1] == _RFMSG_MISSING) && (length == _RFMSG_MISSING_SIZE))
+		_rfmsg_receive_missing(data, source);
+	return true;
+}
+
+// queue a request for the missing fragments, or the confirmation when there are none; returns false if the queue is full
+static bool _rfmsg_send_missing(uint16_t address, uint8_t id, uint32_t missing) {
+	uint8_t *bp = _rf_tx_reserve_to(address);
+	if (!bp)
+		return false;
+
+	*bp++ = RF_PROTOCOL_MSG;
+	*bp++ = _RFMSG_MISSING;
+	*bp++ = id;
+	*bp++ = missing & 0xFF;
+	*bp++ = (missing >> 8) & 0xFF;
+	*bp++ = (missing >> 16) & 0xFF;
+	*bp++ = missing >> 24;
+	_rf_tx_commit_to(_RFMSG_MISSING_SIZE);
+	return true;
+}
+
+// queue as many waiting fragments as the transmit queue has room for
+static void _rfmsg_send_fragments() {
+	while (_rfmsg_tx_pending) {
+		uint8_t index = 0;
+		while (!(_rfmsg_tx_pending & (1UL << index)))
+			index++;
+
+		uint8_t *bp = _rf_tx_reserve_to(_rfmsg_tx_address);
+		if (!bp)
+			return;
+
+		uint16_t offset = index * RFMSG_FRAGMENT_SIZE;
+		uint8_t size = ((_rfmsg_tx_length - offset) < RFMSG_FRAGMENT_SIZE) ? (_rfmsg_tx_length - offset) : RFMSG_FRAGMENT_SIZE;
+
+		*bp++ = RF_PROTOCOL_MSG;
+		*bp++ = _RFMSG_DATA;
+		*bp++ = _rfmsg_tx_id;
+		*bp++ = index;
+		*bp++ = _rfmsg_tx_length & 0xFF;
+		*bp++ = _rfmsg_tx_length >> 8;
+		memcpy(bp, &(_rfmsg_tx_data[offset]), size);
+		_rf_tx_commit_to(_RFMSG_DATA_HEADER + size);
+
+		uint8_t sreg = SREG;
+		cli();
+		_rfmsg_tx_pending &= ~(1UL << index);
+		if (!_rfmsg_tx_pending)
+			_rfmsg_tx_state = _RFMSG_TX_WAITING;
+		_rfmsg_tx_time = clockMillis();
+		SREG = sreg;
+	}
+}
+
+
+/* ---
+#### void rfMsgInit()
+
+Start handling message frames. Call it each time after `rfInit()` and before `rfAddressSet()`:
+the message IDs start from random bits which the radio only makes while it listens in basic mode,
+so different devices are unlikely to use the same IDs at the same time.
+--- */
+
+void rfMsgInit() {
+	memset(_rfmsg_slots, 0, sizeof(_rfmsg_slots));
+	memset(_rfmsg_done, 0, sizeof(_rfmsg_done));
+	_rfmsg_tx_state = _RFMSG_TX_IDLE;
+	for (uint8_t i = 0; (i < 50) && (_RF_TRX_STATUS() != RX_ON); i++)
+		_delay_us(10);	// rfInit() leaves the PLL to lock
+	for (uint8_t i = 0; i < 4; i++) {
+		_rfmsg_tx_id = (_rfmsg_tx_id << 2) | ((PHY_RSSI >> 5) & 0x03);
+		_delay_us(1);	// the radio makes 2 new bits every microsecond
+	}
+	rfHandlerSet(RF_PROTOCOL_MSG, _rfmsg_handler);
+}
+
+/* ---
+#### bool rfMsgSend(uint16_t address, const uint8_t *data, uint16_t length)
+
+Start sending a message of up to `RFMSG_MAX_SIZE` bytes. In basic mode the `address` must be `RF_BROADCAST`.
+
+Only one message is sent at a time. The fragments are sent from `data` by `rfMsgPoll()`, so `data` must not change
+until `rfMsgSending()` returns false.
+
+Returns false if a message is already being sent or the message is too large.
+--- */
+
+bool rfMsgSend(uint16_t address, const uint8_t *data, uint16_t length) {
+	if (!rfInited() || (_rfmsg_tx_state != _RFMSG_TX_IDLE) || !length || (length > RFMSG_MAX_SIZE))
+		return false;
+	if (!_rf_extended)
+		address = RF_BROADCAST;
+
+	_rfmsg_tx_data = data;
+	_rfmsg_tx_length = length;
+	_rfmsg_tx_address = address;
+	_rfmsg_tx_id++;
+	_rfmsg_tx_count = _RFMSG_FRAGMENTS(length);
+
+	uint8_t sreg = SREG;
+	cli();
+	_rfmsg_tx_pending = _RFMSG_ALL(_rfmsg_tx_count);
+	_rfmsg_tx_state = _RFMSG_TX_SENDING;
+	SREG = sreg;
+
+	_rfmsg_send_fragments();
+	return true;
+}
+
+/* ---
+#### bool rfMsgSending()
+
+Return true while the message from `rfMsgSend()` is still needed: until the receiver confirms it has the whole message,
+or nothing has been heard from the receivers for `RFMSG_TIMEOUT` milliseconds (longer with low power listening).
+--- */
+
+bool rfMsgSending() {
+	return (_rfmsg_tx_state != _RFMSG_TX_IDLE);
+}
+
+/* ---
+#### void rfMsgPoll()
+
+Send waiting fragments, ask for missing fragments, and drop messages which have timed out.
+--- */
+
+void rfMsgPoll() {
+	if (!rfInited())
+		return;
+
+	if (_rfmsg_tx_state == _RFMSG_TX_SENDING)
+		_rfmsg_send_fragments();
+
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t now = clockMillis();
+	if ((_rfmsg_tx_state == _RFMSG_TX_WAITING) && ((now - _rfmsg_tx_time) >= _RFMSG_TIMEOUT()))
+		_rfmsg_tx_state = _RFMSG_TX_IDLE;
+	SREG = sreg;
+
+	for (uint8_t i = 0; i < RFMSG_SLOTS; i++) {
+		RFMSG *msg = &(_rfmsg_slots[i]);
+		uint16_t address = (msg->source == RF_ADDRESS_NONE) ? RF_BROADCAST : msg->source;
+
+		// a fragment may arrive at any time between slots, so the time is read along with the slot
+		cli();
+		now = clockMillis();
+		uint8_t state = msg->state;
+		uint32_t missing = msg->missing;
+		uint32_t quiet = now - msg->time;
+		if ((state == _RFMSG_RECEIVING) && (quiet >= _RFMSG_TIMEOUT())) {
+			msg->state = state = _RFMSG_FREE;
+			_rfmsg_dropped++;
+		}
+		SREG = sreg;
+
+		if ((state == _RFMSG_RECEIVING) && (quiet >= (_RFMSG_RETRY() * (msg->retries + 1)))) {
+			if (_rfmsg_send_missing(address, msg->id, missing))
+				msg->retries++;
+		}
+	}
+
+	for (uint8_t i = 0; i < RFMSG_DONE; i++) {
+		RFMSGDONE *done = &(_rfmsg_done[i]);
+		if (done->confirm && _rfmsg_send_missing((done->source == RF_ADDRESS_NONE) ? RF_BROADCAST : done->source, done->id, 0))
+			done->confirm = false;
+	}
+}
+
+/* ---
+#### RFMSG* rfMsgReceive()
+
+Return a complete message, or NULL if there are none. The message remains valid until `rfMsgRelease()` is called.
+
+eg:
+```C
+RFMSG *msg;
+rfMsgPoll();
+while ((msg = rfMsgReceive())) {
+	handleMessage((char *)msg->data, msg->length);
+	rfMsgRelease(msg);
+}
+```
+--- */
+
+RFMSG *rfMsgReceive() {
+	for (uint8_t i = 0; i < RFMSG_SLOTS; i++) {
+		RFMSG *msg = &(_rfmsg_slots[i]);
+		if (msg->state == _RFMSG_COMPLETE) {
+			msg->state = _RFMSG_READING;
+			return msg;
+		}
+	}
+	return NULL;
+}
+
+/* ---
+#### void rfMsgRelease(RFMSG *msg)
+
+Release a message returned by `rfMsgReceive()` so its space may be used for new messages.
+--- */
+
+void rfMsgRelease(RFMSG *msg) {
+	if (msg && (msg->state == _RFMSG_READING))
+		msg->state = _RFMSG_FREE;
+}
+
+/* ---
+#### uint16_t rfMsgDropped()
+
+Return the number of messages dropped because they timed out or there was no room to receive them.
+--- */
+
+uint16_t rfMsgDropped() {
+	return _rfmsg_dropped;
+}
+
+#endif // __SRXE_RFMSG_
@@ -0,0 +1,194 @@
+/* ************************************************************************************
+* File:    rfpower.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### RF Power
+**Send with Only as Much Power as Each Neighbour Needs**
+
+The RF transceiver normally sends at full power (+3.5dBm), which reaches far beyond the devices of a group
+sitting at the same table and drowns out neighbouring groups. With adaptive power, each frame sent to a single device
+uses the lowest power which that device reliably hears.
+
+The link to each neighbour is tracked from the frames received from it: the signal strength (RSSI) at the start of the frame,
+and the link quality (LQI) at the end. Frames to a neighbour start at full power. After `RF_POWER_STEP_DOWN` frames in a row
+are acknowledged, and while the frames from the neighbour are strong and clean, the power is lowered by one step.
+When a frame is not acknowledged, the power is raised by `RF_POWER_STEP_UP` steps and the frame is sent again,
+up to full power.
+
+Adaptive power requires extended mode; see `rfAddressSet()`. Broadcast frames, which are not acknowledged,
+are always sent at full power.
+
+The adaptation is set at compile time:
+```C
+*/
+#ifndef RF_POWER_NEIGHBOURS
+#define RF_POWER_NEIGHBOURS	8		// neighbours whose link is tracked; the least recently heard is replaced
+#endif
+#ifndef RF_POWER_STEP_DOWN
+#define RF_POWER_STEP_DOWN	8		// acknowledged frames in a row before lowering the power one step
+#endif
+#ifndef RF_POWER_STEP_UP
+#define RF_POWER_STEP_UP	2		// steps the power is raised when a frame is not acknowledged
+#endif
+#ifndef RF_POWER_RSSI_MIN
+#define RF_POWER_RSSI_MIN	8		// the power is only lowered while frames from the neighbour are this strong; 8 = -69dBm
+#endif
+#ifndef RF_POWER_LQI_MIN
+#define RF_POWER_LQI_MIN	220		// and have at least this link quality
+#endif
+#ifndef RF_POWER_LOWEST
+#define RF_POWER_LOWEST		15		// the lowest power used; 0 = +3.5dBm .. 15 = -16.5dBm
+#endif
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_RFPOWER_
+#define __SRXE_RFPOWER_
+
+#include "common.h"
+#include "rf.h"
+
+/* ---
+The link to each neighbour is an `RFLINK`:
+```C
+*/
+#define RF_POWER_FULL	0			// the PHY_TX_PWR level of full power
+
+typedef struct _RFLINK {
+	uint16_t address;		// short address of the neighbour; RF_ADDRESS_NONE when the entry is not in use
+	uint8_t rssi;			// average signal strength of the frames from the neighbour; 0..28 in 3dB steps from -90dBm
+	uint8_t lqi;			// average link quality of the frames from the neighbour; 0..255
+	uint8_t level;			// PHY_TX_PWR level used for frames to the neighbour; 0 (full power) .. 15
+	uint8_t acked;			// frames acknowledged in a row
+	uint16_t missed;		// frames which were not acknowledged
+} RFLINK;
+/*
+```
+--- */
+
+static RFLINK _rf_power_links[RF_POWER_NEIGHBOURS];
+static uint8_t _rf_power_age[RF_POWER_NEIGHBOURS];	// frames from others since the neighbour was last heard from or sent to
+
+// return the link to a neighbour, or replace the least recently used link when 'create' is true; called from the interrupts
+static RFLINK *_rf_power_find(uint16_t address, bool create) {
+	uint8_t oldest = 0;
+	for (uint8_t i = 0; i < RF_POWER_NEIGHBOURS; i++) {
+		if (_rf_power_links[i].address == address) {
+			oldest = i;
+			create = false;
+			break;
+		}
+		if (_rf_power_age[i] > _rf_power_age[oldest])
+			oldest = i;
+	}
+	if (!create && (_rf_power_links[oldest].address != address))
+		return NULL;
+
+	for (uint8_t i = 0; i < RF_POWER_NEIGHBOURS; i++) {
+		if (_rf_power_age[i] < 0xFF)
+			_rf_power_age[i]++;
+	}
+	_rf_power_age[oldest] = 0;
+
+	RFLINK *link = &(_rf_power_links[oldest]);
+	if (create) {
+		link->address = address;
+		link->rssi = 0;
+		link->lqi = 0;
+		link->level = RF_POWER_FULL;
+		link->acked = 0;
+		link->missed = 0;
+	}
+	return link;
+}
+
+// registered with rf.h; called from the receive interrupt for each frame
+static void _rf_power_heard(uint16_t source, uint8_t rssi, uint8_t lqi) {
+	RFLINK *link = _rf_power_find(source, true);
+	if (!link->lqi) {
+		link->rssi = rssi;
+		link->lqi = lqi;
+	} else {
+		link->rssi = ((uint16_t)link->rssi * 3 + rssi) / 4;
+		link->lqi = ((uint16_t)link->lqi * 3 + lqi) / 4;
+	}
+}
+
+// registered with rf.h; called when a frame is loaded to be sent
+static uint8_t _rf_power_level(uint16_t address) {
+	if (address == RF_BROADCAST)
+		return RF_POWER_FULL;
+	RFLINK *link = _rf_power_find(address, false);
+	return link ? link->level : RF_POWER_FULL;
+}
+
+// registered with rf.h; called from the transmit interrupt with the result of a frame which asked for an acknowledgement
+static bool _rf_power_result(uint16_t address, uint8_t status) {
+	RFLINK *link = _rf_power_find(address, true);
+
+	if (status == RF_TX_SUCCESS) {
+		if (++link->acked >= RF_POWER_STEP_DOWN) {
+			link->acked = 0;
+			if ((link->level < RF_POWER_LOWEST) && (link->rssi >= RF_POWER_RSSI_MIN) && (link->lqi >= RF_POWER_LQI_MIN))
+				link->level++;
+		}
+		return false;
+	}
+
+	link->acked = 0;
+	if (status != RF_TX_NO_ACK)
+		return false;	// the channel was busy; more power will not help
+
+	link->missed++;
+	if (link->level == RF_POWER_FULL)
+		return false;
+	link->level = (link->level > RF_POWER_STEP_UP) ? (link->level - RF_POWER_STEP_UP) : RF_POWER_FULL;
+	return true;
+}
+
+
+/* ---
+#### void rfPowerAdapt(bool on)
+
+Start adapting the transmit power to each neighbour, or stop and send every frame at full power.
+What has been learned about each neighbour is forgotten.
+--- */
+
+void rfPowerAdapt(bool on) {
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t i = 0; i < RF_POWER_NEIGHBOURS; i++) {
+		_rf_power_links[i].address = RF_ADDRESS_NONE;
+		_rf_power_age[i] = 0xFF;
+	}
+	_rf_tx_power_hook = on ? _rf_power_level : NULL;
+	_rf_tx_result_hook = on ? _rf_power_result : NULL;
+	_rf_rx_link_hook = on ? _rf_power_heard : NULL;
+	PHY_TX_PWR = (PHY_TX_PWR & 0xF0) | RF_POWER_FULL;
+	SREG = sreg;
+}
+
+/* ---
+#### const RFLINK* rfPowerLink(uint16_t address)
+
+Return what is known of the link to the neighbour with the given short address, or NULL if it is not known.
+--- */
+
+const RFLINK *rfPowerLink(uint16_t address) {
+	for (uint8_t i = 0; i < RF_POWER_NEIGHBOURS; i++) {
+		if ((_rf_power_links[i].address == address) && (address != RF_ADDRESS_NONE))
+			return &(_rf_power_links[i]);
+	}
+	return NULL;
+}
+
+#endif // __SRXE_RFPOWER_
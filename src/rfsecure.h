@@ -0,0 +1,350 @@
+/* ************************************************************************************
+* File:    rfsecure.h
+* Date:    2026.10.16
+* Author:  Bradan Lane Studio
+*
+* This content may be redistributed and/or modified as outlined under the MIT License
+*
+* ************************************************************************************/
+
+/* ---
+
+### RF Secure
+**Encrypt and Authenticate Frames with a Group Key**
+
+Without security any device on the same channel can read, and forge, every frame.
+With a 128 bit key shared by a group, each frame is encrypted and carries a 4 byte message integrity code (MIC).
+Devices without the key can neither read the frames nor send frames which the group will accept.
+
+The on-chip AES engine of the ATmega128RFA1 does the work. The data is encrypted with AES in counter mode and
+the MIC is an AES CBC-MAC of the data, as in the CCM mode of IEEE 802.15.4. The ID of the sender (from `eepromSignature()`)
+and a frame counter form the nonce, so no two frames use the same keystream. The frame counter also protects against replay:
+a frame is dropped unless its counter is higher than the last one accepted from the same sender.
+Only the last `RF_SECURE_PEERS` senders are remembered; when another sender takes the place of one, the counter of the one
+it replaces becomes a floor, and frames from senders which are not remembered are dropped unless their counter is above it.
+So a group should have no more than `RF_SECURE_PEERS` devices, or a device which has sent fewer frames than the others
+is not heard until its counter passes the floor.
+The upper half of the counter is kept in EEPROM so a restart does not reuse counters.
+
+The work is overlapped with moving the frame: data is encrypted straight into the transmit queue, and decrypted straight from
+the transceiver frame buffer into the receive ring, while the CPU prepares the next block as the AES engine works on the current one.
+
+While security is on, the byte and frame functions send secure frames, and the receive ring only holds frames which were
+decrypted and authenticated. Frames of the other protocols, eg: `rfmsg.h`, `rfchannel.h`, and `rfmesh.h`, are not protected.
+`eepromInit()` must be called before `rfSecureSet()`.
+
+Security is set at compile time:
+```C
+*/
+#ifndef RF_SECURE_PEERS
+#define RF_SECURE_PEERS		8		// senders whose frame counter is remembered for replay protection
+#endif
+#ifndef RF_SECURE_EEPROM
+#define RF_SECURE_EEPROM	(EEPROM_LAST_AVAILABLE - 1)	// 2 bytes of EEPROM for the upper half of the frame counter
+#endif
+/*
+```
+--------------------------------------------------------------------------
+--- */
+
+#ifndef __SRXE_RFSECURE_
+#define __SRXE_RFSECURE_
+
+#include "common.h"
+#include "eeprom.h"
+#include "rf.h"
+
+#define RF_PROTOCOL_SECURE	0x83
+
+/* ---
+```C
+*/
+#define RF_SECURE_KEY_SIZE		16
+#define RF_SECURE_HEADER_SIZE	11	// protocol, sender ID (6), frame counter (4, LSB first)
+#define RF_SECURE_MIC_SIZE		4
+#define RF_SECURE_PAYLOAD_SIZE	(RF_FRAME_PAYLOAD_SIZE - RF_SECURE_HEADER_SIZE - RF_SECURE_MIC_SIZE)
+/*
+```
+--- */
+
+#define _RF_AES_BLOCK	16
+#define _RF_AES_NONCE	(EEPROM_ID_SIZE + 4)	// sender ID and frame counter
+
+typedef struct _RFSECUREPEER {
+	char id[EEPROM_ID_SIZE];
+	uint32_t counter;		// the last frame counter accepted from the sender
+	uint8_t used;			// frames accepted from others since the last one from this sender
+} RFSECUREPEER;
+
+static uint8_t _rf_secure_key[RF_SECURE_KEY_SIZE];
+static bool _rf_secure_on;
+static uint32_t _rf_secure_counter;
+static RFSECUREPEER _rf_secure_peers[RF_SECURE_PEERS];
+static uint32_t _rf_secure_floor;	// the highest counter of the senders which were replaced; the lowest a new sender may use
+static uint16_t _rf_secure_rejected, _rf_secure_replayed;
+
+// start an AES-128 ECB encryption of one block; the key is loaded each time because the engine leaves the last round key in AES_KEY
+static void _rf_aes_start(const uint8_t *in) {
+	for (uint8_t i = 0; i < RF_SECURE_KEY_SIZE; i++)
+		AES_KEY = _rf_secure_key[i];
+	for (uint8_t i = 0; i < _RF_AES_BLOCK; i++)
+		AES_STATE = in[i];
+	AES_CTRL = (1 << AES_REQUEST);	// ECB, encrypt
+}
+
+// wait for the block to be done (about 24us) and read it
+static void _rf_aes_finish(uint8_t *out) {
+	while (!(AES_STATUS & (1 << AES_DONE)))
+		;
+	for (uint8_t i = 0; i < _RF_AES_BLOCK; i++)
+		out[i] = AES_STATE;
+}
+
+// the counter block for block 'i' of a frame, and for the MIC when 'i' is 0
+static void _rf_aes_counter_block(uint8_t *block, const uint8_t *nonce, uint8_t i) {
+	memset(block, 0, _RF_AES_BLOCK);
+	block[0] = 0x01;					// CCM flags; 2 byte counter
+	memcpy(&(block[1]), nonce, _RF_AES_NONCE);
+	block[_RF_AES_BLOCK - 1] = i;
+}
+
+/*
+	encrypt or decrypt 'length' bytes from 'in' to 'out' and compute the MIC of the plain data
+
+	the engine is shared by the receive interrupt and the program so interrupts are held off for each step of one or two blocks;
+	while the engine works on one block the CPU prepares the next or writes out the last
+*/
+static void _rf_secure_crypt(const uint8_t *nonce, const uint8_t *in, uint8_t *out, uint8_t length, bool encrypt, uint8_t *mic) {
+	uint8_t a[_RF_AES_BLOCK];	// counter block
+	uint8_t s[_RF_AES_BLOCK];	// keystream
+	uint8_t x[_RF_AES_BLOCK];	// CBC-MAC
+	uint8_t sreg = SREG;
+
+	// the first block of the CBC-MAC holds the nonce and the length
+	memset(x, 0, _RF_AES_BLOCK);
+	x[0] = 0x09;					// CCM flags; 4 byte MIC, 2 byte counter
+	memcpy(&(x[1]), nonce, _RF_AES_NONCE);
+	x[_RF_AES_BLOCK - 1] = length;
+	cli();
+	_rf_aes_start(x);
+	_rf_aes_counter_block(a, nonce, 1);
+	_rf_aes_finish(x);
+	SREG = sreg;
+
+	for (uint8_t i = 1, offset = 0; offset < length; i++, offset += _RF_AES_BLOCK) {
+		uint8_t count = ((length - offset) < _RF_AES_BLOCK) ? (length - offset) : _RF_AES_BLOCK;
+		const uint8_t *ip = &(in[offset]);
+		uint8_t *op = &(out[offset]);
+
+		cli();
+		_rf_aes_start(a);
+		if (encrypt) {
+			for (uint8_t j = 0; j < count; j++)
+				x[j] ^= ip[j];
+		}
+		a[_RF_AES_BLOCK - 1] = i + 1;
+		_rf_aes_finish(s);
+
+		if (encrypt) {
+			_rf_aes_start(x);
+			for (uint8_t j = 0; j < count; j++)
+				op[j] = ip[j] ^ s[j];
+		} else {
+			for (uint8_t j = 0; j < count; j++) {
+				op[j] = ip[j] ^ s[j];
+				x[j] ^= op[j];
+			}
+			_rf_aes_start(x);
+		}
+		_rf_aes_finish(x);
+		SREG = sreg;
+	}
+
+	// the MIC is the CBC-MAC encrypted with the first keystream block
+	cli();
+	_rf_aes_counter_block(a, nonce, 0);
+	_rf_aes_start(a);
+	_rf_aes_finish(s);
+	SREG = sreg;
+	for (uint8_t j = 0; j < RF_SECURE_MIC_SIZE; j++)
+		mic[j] = x[j] ^ s[j];
+}
+
+// return the sender, or the least recently heard peer which a new sender would replace
+static RFSECUREPEER *_rf_secure_peer(const char *id) {
+	RFSECUREPEER *oldest = &(_rf_secure_peers[0]);
+	for (uint8_t i = 0; i < RF_SECURE_PEERS; i++) {
+		RFSECUREPEER *peer = &(_rf_secure_peers[i]);
+		if (!memcmp(peer->id, id, EEPROM_ID_SIZE))
+			return peer;
+		if (peer->used > oldest->used)
+			oldest = peer;
+	}
+	return oldest;
+}
+
+// registered with rf.h; called from the receive interrupt
+// the frame is decrypted from the frame buffer directly into the next free slot of the receive ring
+static bool _rf_secure_handler(const uint8_t *data, uint8_t length, uint16_t source) {
+	if (length < (RF_SECURE_HEADER_SIZE + RF_SECURE_MIC_SIZE)) {
+		_rf_secure_rejected++;
+		return true;
+	}
+	length -= RF_SECURE_HEADER_SIZE + RF_SECURE_MIC_SIZE;
+
+	const uint8_t *nonce = &(data[1]);
+	uint32_t counter;
+	memcpy(&counter, &(nonce[EEPROM_ID_SIZE]), sizeof(counter));
+
+	// a new sender only replaces a peer once its frame is authenticated
+	RFSECUREPEER *peer = _rf_secure_peer((const char *)nonce);
+	bool known = !memcmp(peer->id, nonce, EEPROM_ID_SIZE);
+	if (known && (counter <= peer->counter)) {
+		_rf_secure_replayed++;
+		return true;
+	}
+	// a replaced sender is no longer known, so its old frames would otherwise be accepted again
+	if (!known && (counter <= _rf_secure_floor)) {
+		_rf_secure_replayed++;
+		return true;
+	}
+
+	RFFRAME *frame = _rf_rx_reserve();
+	if (!frame)
+		return true;
+
+	uint8_t mic[RF_SECURE_MIC_SIZE];
+	_rf_secure_crypt(nonce, &(data[RF_SECURE_HEADER_SIZE]), frame->data, length, false, mic);
+	if (memcmp(mic, &(data[RF_SECURE_HEADER_SIZE + length]), RF_SECURE_MIC_SIZE)) {
+		_rf_secure_rejected++;	// the slot is not committed so it is reused
+		return true;
+	}
+
+	for (uint8_t i = 0; i < RF_SECURE_PEERS; i++) {
+		if (_rf_secure_peers[i].used < 0xFF)
+			_rf_secure_peers[i].used++;
+	}
+	if (!known && (peer->counter > _rf_secure_floor))
+		_rf_secure_floor = peer->counter;
+	memcpy(peer->id, nonce, EEPROM_ID_SIZE);
+	peer->counter = counter;
+	peer->used = 0;
+	_rf_rx_commit(length);
+	return true;
+}
+
+// keep the upper half of the frame counter ahead of any counter already used
+static void _rf_secure_counter_save() {
+	uint16_t high = _rf_secure_counter >> 16;
+	eepromWriteByte(RF_SECURE_EEPROM, high & 0xFF);
+	eepromWriteByte(RF_SECURE_EEPROM + 1, high >> 8);
+}
+
+int rfSecureSend(uint16_t address, const uint8_t *data, uint8_t length);
+
+// the byte functions send their frames through here while security is on
+static int _rf_secure_tx_frame(const uint8_t *data, uint8_t length) {
+	return rfSecureSend(RF_BROADCAST, data, length);
+}
+
+
+/* ---
+#### void rfSecureSet(const uint8_t *key)
+
+Turn on security with the 16 byte key of the group. Call it after `rfInit()` and `eepromInit()`.
+--- */
+
+void rfSecureSet(const uint8_t *key) {
+	uint8_t sreg = SREG;
+	cli();
+	memcpy(_rf_secure_key, key, RF_SECURE_KEY_SIZE);
+	memset(_rf_secure_peers, 0, sizeof(_rf_secure_peers));
+	for (uint8_t i = 0; i < RF_SECURE_PEERS; i++)
+		_rf_secure_peers[i].used = 0xFF;
+	_rf_secure_floor = 0;
+	SREG = sreg;
+
+	if (!_rf_secure_on) {
+		// start beyond every counter used before the last restart
+		uint16_t high = eepromReadByte(RF_SECURE_EEPROM) | (eepromReadByte(RF_SECURE_EEPROM + 1) << 8);
+		_rf_secure_counter = (uint32_t)(high + 1) << 16;
+		_rf_secure_counter_save();
+	}
+	_rf_secure_on = true;
+
+	rfHandlerSet(RF_PROTOCOL_SECURE, _rf_secure_handler);
+	sreg = SREG;
+	cli();
+	_rf_tx_frame_hook = _rf_secure_tx_frame;
+	_rf_tx_frame_hook_size = RF_SECURE_PAYLOAD_SIZE;
+	_rf_rx_secure_only = true;
+	SREG = sreg;
+}
+
+/* ---
+#### void rfSecureClear()
+
+Turn off security; frames are sent and received as plain data.
+--- */
+
+void rfSecureClear() {
+	uint8_t sreg = SREG;
+	cli();
+	_rf_tx_frame_hook = NULL;
+	_rf_rx_secure_only = false;
+	SREG = sreg;
+	rfHandlerSet(RF_PROTOCOL_SECURE, NULL);
+	memset(_rf_secure_key, 0, RF_SECURE_KEY_SIZE);
+	_rf_secure_on = false;
+}
+
+/* ---
+#### int rfSecureSend(uint16_t address, const uint8_t *data, uint8_t length)
+
+Encrypt and queue up to `RF_SECURE_PAYLOAD_SIZE` (101) bytes for the device with the given short address, or `RF_BROADCAST`.
+The address is only used in extended mode; see `rfAddressSet()`. The receiver gets the data as a normal frame; see `rfReceiveFrame()`.
+
+Returns a ticket for the frame, as `rfSendTo()`, or -1 if security is off, the data is too large, or the queue is full.
+--- */
+
+int rfSecureSend(uint16_t address, const uint8_t *data, uint8_t length) {
+	if (!_rf_secure_on || (length > RF_SECURE_PAYLOAD_SIZE))
+		return -1;
+
+	uint8_t *bp = _rf_tx_reserve_to(address);
+	if (!bp)
+		return -1;
+
+	uint32_t counter = ++_rf_secure_counter;
+	if (!(counter & 0xFFFF))
+		_rf_secure_counter_save();
+
+	bp[0] = RF_PROTOCOL_SECURE;
+	memcpy(&(bp[1]), eepromSignature(), EEPROM_ID_SIZE);
+	memcpy(&(bp[1 + EEPROM_ID_SIZE]), &counter, sizeof(counter));
+	_rf_secure_crypt(&(bp[1]), data, &(bp[RF_SECURE_HEADER_SIZE]), length, true, &(bp[RF_SECURE_HEADER_SIZE + length]));
+
+	return _rf_tx_commit_to(RF_SECURE_HEADER_SIZE + length + RF_SECURE_MIC_SIZE);
+}
+
+/* ---
+#### uint16_t rfSecureRejected()
+
+Return the number of frames dropped because they failed authentication or were not secure.
+--- */
+
+uint16_t rfSecureRejected() {
+	return _rf_secure_rejected + _rf_rx_insecure;
+}
+
+/* ---
+#### uint16_t rfSecureReplayed()
+
+Return the number of frames dropped because their frame counter had already been used, or was below the floor for new senders.
+--- */
+
+uint16_t rfSecureReplayed() {
+	return _rf_secure_replayed;
+}
+
+#endif // __SRXE_RFSECURE_
@@ -359,6 +359,349 @@ void uiLinesBox (const char* lines[], uint8_t x, uint8_t y, uint8_t w, uint8_t h
 
 
 
+/* ---
+#### void uiPaneInit()
+
+Create a scrolling text pane, such as a chat transcript, using the hardware scroll of the LCD.
+
+The input parameters are:
+- uint8_t y - top of the pane
+- uint8_t h - height of the pane; it is rounded down to a whole number of lines
+- uint8_t font_id - font used for the text in the pane
+
+The pane is the full width of the screen. Everything above and below the pane is not scrolled, so a status bar
+and an input area may be drawn there as usual. Adding a line to the pane scrolls it by one line and draws only the new line.
+
+The pane is erased using the current background color.
+
+**Note:** The LCD has a single scroll area so there may only be one pane. Use `uiPaneEnd()` to remove it.
+--- */
+
+static uint8_t _ui_pane_y, _ui_pane_lines, _ui_pane_font, _ui_pane_line_height;
+
+void uiPaneInit(uint8_t y, uint8_t h, uint8_t font_id) {
+	uint8_t saved_font = lcdFontGetNum();
+	lcdFontSet(font_id);
+
+	_ui_pane_y = y;
+	_ui_pane_font = font_id;
+	_ui_pane_line_height = lcdFontHeightGet();
+	_ui_pane_lines = 0;
+
+	if ((y < LCD_HEIGHT) && (h > (LCD_HEIGHT - y)))
+		h = LCD_HEIGHT - y;
+	if ((y < LCD_HEIGHT) && _ui_pane_line_height)
+		_ui_pane_lines = h / _ui_pane_line_height;
+
+	if (_ui_pane_lines) {
+		h = _ui_pane_lines * _ui_pane_line_height;
+		// the bottom fixed area includes the rows of the LCD driver which are below the visible screen
+		lcdScrollSet(y, h, LCD_DRIVER_HEIGHT - y - h);
+		lcdRectangle(0, y, LCD_WIDTH, h, LCD_ERASE);
+	}
+
+	lcdFontSet(saved_font);
+}
+
+/* ---
+#### void uiPaneAdd(const char* text)
+
+Add text to the bottom of the pane using the current colors.
+Text wider than the pane is wrapped onto as many lines as needed; a newline character also starts a new line.
+
+Each new line scrolls the pane up by one line. Only the new line is drawn.
+
+**Note:** the wrap feature does not use any word break algorithm.
+--- */
+
+void uiPaneAdd(const char* text) {
+	if (!_ui_pane_lines)
+		return;
+
+	uint8_t saved_font = lcdFontGetNum();
+	lcdFontSet(_ui_pane_font);
+
+	uint8_t cols = LCD_WIDTH / lcdFontWidthGet();
+	uint8_t h = _ui_pane_line_height;
+
+	do {
+		uint8_t len = 0;
+		while (text[len] && (text[len] != '\n') && (len < cols))
+			len++;
+
+		// the line at the top of the pane wraps around to the bottom, where it is replaced by the new line
+		lcdScrollLines(h);
+		uint8_t row = lcdScrollRow((_ui_pane_lines - 1) * h);
+
+		lcdPositionSet(0, row);
+		int x = len ? _lcd_put_string(text, len) : 0;
+		if (x < 0)
+			x = lcdPositionGetX();	// the characters which fit were drawn; only the rest of the line is erased
+		if (x < LCD_WIDTH)
+			lcdRectangle(x, row, LCD_WIDTH - x, h, LCD_ERASE);
+
+		text += len;
+		if (*text == '\n')
+			text++;
+	} while (*text);
+
+	lcdFontSet(saved_font);
+}
+
+/* ---
+#### void uiPaneClear()
+
+Erase the pane using the current background color.
+--- */
+
+void uiPaneClear() {
+	if (!_ui_pane_lines)
+		return;
+	lcdScrollSet(_ui_pane_y, _ui_pane_lines * _ui_pane_line_height, LCD_DRIVER_HEIGHT - _ui_pane_y - (_ui_pane_lines * _ui_pane_line_height));
+	lcdRectangle(0, _ui_pane_y, LCD_WIDTH, _ui_pane_lines * _ui_pane_line_height, LCD_ERASE);
+}
+
+/* ---
+#### void uiPaneEnd()
+
+Remove the pane and return the LCD to normal, unscrolled operation. The contents of the pane are erased.
+--- */
+
+void uiPaneEnd() {
+	if (!_ui_pane_lines)
+		return;
+	uiPaneClear();
+	lcdScrollReset();
+	_ui_pane_lines = 0;
+}
+
+
+/* ---
+#### Input Editor
+
+A multi-line input area, anchored at the bottom, which grows upward as text is added.
+The editor remembers what it last drew, so each keypress only redraws the cells which changed - typically
+the new (or deleted) character and the cursor. The whole area is only redrawn when the number of rows changes.
+
+The time from a keypress to the change being sent to the LCD is measured and available from `uiEditorLatency()`
+and `uiEditorLatencyMax()`, in microseconds.
+
+```C
+*/
+typedef struct _UIEDITOR {
+	char *buffer;				// text being edited; always null terminated
+	uint8_t size;				// size of the buffer
+	uint8_t length;				// number of characters in the buffer
+	uint8_t x, bottom, w;		// left, bottom (one past the last row), and width of the input area
+	uint8_t font;				// font used for the input
+	uint8_t drawn_length;		// length when the editor was last drawn
+	uint8_t drawn_rows;			// number of rows when the editor was last drawn; 0 = must redraw everything
+	uint32_t key_time;			// clockMicros() of the oldest keypress which has not been drawn; 0 = none
+	uint32_t latency;			// microseconds from the most recent keypress to its change being sent
+	uint32_t latency_max;		// largest latency since the editor was initialized
+} UIEDITOR;
+/*
+```
+--- */
+
+#define UI_EDITOR_CURSOR	'_'
+
+/* ---
+#### void uiEditorInit()
+
+Initialize an input editor. The buffer is erased. Nothing is drawn until `uiEditorDraw()`.
+
+The input parameters are:
+- UIEDITOR* editor - the editor
+- char* buffer[] - buffer to receive user input
+- uint8_t size - length of buffer
+- uint8_t x - left position of input area
+- uint8_t bottom - the bottom of the input area; the area grows upward from here
+- uint8_t w - width of input area
+- uint8_t font_id - font used for the input
+--- */
+
+void uiEditorInit(UIEDITOR *editor, char *buffer, uint8_t size, uint8_t x, uint8_t bottom, uint8_t w, uint8_t font_id) {
+	memset(editor, 0, sizeof(UIEDITOR));
+	memset(buffer, 0, size);
+	editor->buffer = buffer;
+	editor->size = size;
+	editor->x = x;
+	editor->bottom = bottom;
+	editor->w = w;
+	editor->font = font_id;
+}
+
+// the keypress time is kept from the first change which has not been drawn
+static void _ui_editor_changed(UIEDITOR *editor) {
+	if (!editor->key_time)
+		editor->key_time = clockMicros() | 1;	// never 0
+}
+
+/* ---
+#### bool uiEditorInsert(UIEDITOR* editor, char c)
+
+Add a character to the end of the input. Returns false if the buffer is full.
+--- */
+
+bool uiEditorInsert(UIEDITOR *editor, char c) {
+	if (editor->length >= (editor->size - 1))
+		return false;
+	_ui_editor_changed(editor);
+	editor->buffer[editor->length++] = c;
+	editor->buffer[editor->length] = 0;
+	return true;
+}
+
+/* ---
+#### bool uiEditorDelete(UIEDITOR* editor)
+
+Remove the last character of the input. Returns false if the input is empty.
+--- */
+
+bool uiEditorDelete(UIEDITOR *editor) {
+	if (!editor->length)
+		return false;
+	_ui_editor_changed(editor);
+	editor->buffer[--editor->length] = 0;
+	return true;
+}
+
+/* ---
+#### void uiEditorClear(UIEDITOR* editor)
+
+Remove all of the input.
+--- */
+
+void uiEditorClear(UIEDITOR *editor) {
+	_ui_editor_changed(editor);
+	memset(editor->buffer, 0, editor->size);
+	editor->length = 0;
+}
+
+/* ---
+#### void uiEditorRedraw(UIEDITOR* editor)
+
+Force the next `uiEditorDraw()` to draw the whole input area; eg: after the screen has been cleared.
+--- */
+
+void uiEditorRedraw(UIEDITOR *editor) {
+	editor->drawn_rows = 0;
+}
+
+/* ---
+#### uint8_t uiEditorHeight(UIEDITOR* editor)
+
+Return the height of the input area for the current input. The area grows upward from `bottom`.
+--- */
+
+uint8_t uiEditorHeight(UIEDITOR *editor) {
+	uint8_t saved_font = lcdFontGetNum();
+	lcdFontSet(editor->font);
+	uint8_t h = ((editor->length / (editor->w / lcdFontWidthGet())) + 1) * lcdFontHeightGet();
+	lcdFontSet(saved_font);
+	return h;
+}
+
+// draw one cell: a character, the cursor, or nothing
+static void _ui_editor_draw_cell(UIEDITOR *editor, uint8_t i, uint8_t top, uint8_t cols, uint8_t fw, uint8_t fh) {
+	uint8_t x = editor->x + (i % cols) * fw;
+	uint8_t y = top + (i / cols) * fh;
+
+	if (i <= editor->length) {
+		lcdPositionSet(x, y);
+		lcdPutChar((i < editor->length) ? editor->buffer[i] : UI_EDITOR_CURSOR);
+	} else {
+		lcdRectangle(x, y, fw, fh, LCD_ERASE);
+	}
+}
+
+/* ---
+#### void uiEditorDraw(UIEDITOR* editor)
+
+Send any changes to the LCD. It is safe to call when nothing has changed.
+
+_The function uses the current color._
+--- */
+
+void uiEditorDraw(UIEDITOR *editor) {
+	if (editor->drawn_rows && !editor->key_time)
+		return;
+
+	uint8_t saved_font = lcdFontGetNum();
+	lcdFontSet(editor->font);
+
+	uint8_t fw = lcdFontWidthGet();
+	uint8_t fh = lcdFontHeightGet();
+	uint8_t cols = editor->w / fw;
+	uint8_t rows = (editor->length / cols) + 1;
+	uint8_t top = editor->bottom - (rows * fh);
+
+	if (rows != editor->drawn_rows) {
+		// the rows have moved so everything is drawn; each row is sent as a run
+		for (uint8_t r = 0; r < rows; r++) {
+			uint8_t start = r * cols;
+			uint8_t count = (editor->length > start) ? (editor->length - start) : 0;
+			if (count > cols)
+				count = cols;
+			lcdPositionSet(editor->x, top + (r * fh));
+			if (count)
+				_lcd_put_string(&(editor->buffer[start]), count);
+			if (count < cols)
+				lcdPutChar(UI_EDITOR_CURSOR);
+			if (lcdPositionGetX() < (editor->x + editor->w))
+				lcdRectangle(lcdPositionGetX(), top + (r * fh), (editor->x + editor->w) - lcdPositionGetX(), fh, LCD_ERASE);
+		}
+		// erase any rows the input no longer uses
+		if (editor->drawn_rows > rows)
+			lcdRectangle(editor->x, editor->bottom - (editor->drawn_rows * fh), editor->w, (editor->drawn_rows - rows) * fh, LCD_ERASE);
+	} else {
+		// only the cells between the old and new end of the input have changed; this includes both cursor positions
+		uint8_t first = (editor->drawn_length < editor->length) ? editor->drawn_length : editor->length;
+		uint8_t last = (editor->drawn_length > editor->length) ? editor->drawn_length : editor->length;
+		for (uint8_t i = first; i <= last; i++)
+			_ui_editor_draw_cell(editor, i, top, cols, fw, fh);
+	}
+
+	editor->drawn_length = editor->length;
+	editor->drawn_rows = rows;
+
+	lcdFontSet(saved_font);
+
+#ifdef __SRXE_LCDDEFER_
+	// typing must not wait for the rest of the frame
+	lcdFlush();
+#endif
+
+	if (editor->key_time) {
+		editor->latency = clockMicros() - editor->key_time;
+		if (editor->latency > editor->latency_max)
+			editor->latency_max = editor->latency;
+		editor->key_time = 0;
+	}
+}
+
+/* ---
+#### uint32_t uiEditorLatency(UIEDITOR* editor)
+
+Return the microseconds from the most recent keypress to its change being sent to the LCD.
+--- */
+
+uint32_t uiEditorLatency(UIEDITOR *editor) {
+	return editor->latency;
+}
+
+/* ---
+#### uint32_t uiEditorLatencyMax(UIEDITOR* editor)
+
+Return the largest keypress to LCD latency, in microseconds, since the editor was initialized.
+--- */
+
+uint32_t uiEditorLatencyMax(UIEDITOR *editor) {
+	return editor->latency_max;
+}
+
+
 /* ---
 #### void uiInputBox()
 